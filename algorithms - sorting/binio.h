@@ -0,0 +1,506 @@
+/*
+    binio.h
+    10/19/26
+
+    number files for the sort tests: a binary format that is mapped into
+    memory as it is, and a fast parser for the one-number-per-line text
+    files made by earlier versions of ranuint.x
+
+      fsu::NumberFile<T>   - opens either kind read-only: Begin, End, Size, []
+      fsu::NumberWriter<T> - writes either kind, a number or an array at a time
+      fsu::ParseNumber     - text to number, in the manner of C++17 from_chars
+      fsu::FormatNumber    - number to text, in the manner of C++17 to_chars
+
+    Binary format: a 64-byte header, then count elements, all little-endian
+
+      offset  size
+         0      4  magic "FSUN"
+         4      1  version (1)
+         5      1  element width in bytes: 1, 2, 4 or 8
+         6      1  kind: 0 unsigned, 1 signed, 2 floating
+         7      1  0
+         8      8  count of elements
+        16     48  0
+
+    The header is a whole cache line, so the elements that follow a mapped
+    header are aligned for any element type. NumberFile maps the file and
+    points straight into the mapping: nothing is copied or converted, and
+    pages are read as the first sort touches them. A file whose width or
+    kind is not T's is refused, not converted. On a big-endian host the
+    elements are read and byte-swapped instead.
+
+    Text format: numbers separated by white space (in practice, one per
+    line). The file is mapped and parsed in one pass with ParseNumber;
+    there is no locale, no stream state and no per-number call through
+    operator >>. Text is read only into integer types (NumberWriter writes
+    floating types as text too, with enough digits to be exact).
+
+    NumberFile::Open with format_auto tells the two apart by the magic.
+
+    NumberWriter::Write puts a whole array: binary goes to the file in one
+    write, and text is formatted a block of numbers per task on a TaskPool
+    (tpool.h), the blocks written in order as each round of them is done.
+
+    Errors are reported by Open and Close returning false, with a message
+    in Error().
+*/
+
+#ifndef _BINIO_H
+#define _BINIO_H
+
+#include <cstdlib>   // size_t
+#include <cstdint>
+#include <cstring>   // memcpy, memset
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <type_traits>
+#include <tpool.h>
+#include <fcntl.h>   // open
+#include <unistd.h>  // close
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace fsu
+{
+
+  enum NumberFormat { format_auto, format_text, format_binary };
+
+  namespace binio
+  {
+
+    const size_t  header_size = 64;
+    const char    magic [4]   = { 'F', 'S', 'U', 'N' };
+    const uint8_t version     = 1;
+
+    enum Kind { kind_unsigned = 0, kind_signed = 1, kind_floating = 2 };
+
+    template < typename T >
+    struct KindOf
+    {
+      static const uint8_t value = std::is_floating_point<T>::value ? kind_floating
+                                 : std::is_signed<T>::value         ? kind_signed
+                                 :                                    kind_unsigned;
+    };
+
+    inline const char* KindName (uint8_t kind)
+    {
+      switch (kind)
+      {
+        case kind_unsigned: return "unsigned";
+        case kind_signed:   return "signed";
+        case kind_floating: return "floating";
+        default:            return "unknown";
+      }
+    }
+
+    inline bool LittleEndian ()
+    {
+      const uint16_t one = 1;
+      return *(const unsigned char*)&one == 1;
+    }
+
+    // reverses the bytes of each of n elements of width w
+    inline void SwapBytes (void* p, size_t n, size_t w)
+    {
+      unsigned char* b = (unsigned char*)p;
+      for (size_t i = 0; i < n; ++i, b += w)
+        for (size_t j = 0; j < w / 2; ++j)
+        {
+          unsigned char t = b[j]; b[j] = b[w - 1 - j]; b[w - 1 - j] = t;
+        }
+    }
+
+    inline void PutCount (unsigned char* h, uint64_t count)
+    {
+      for (size_t i = 0; i < 8; ++i)
+        h[8 + i] = (unsigned char)(count >> (8 * i));
+    }
+
+    inline uint64_t GetCount (const unsigned char* h)
+    {
+      uint64_t count = 0;
+      for (size_t i = 0; i < 8; ++i)
+        count |= (uint64_t)h[8 + i] << (8 * i);
+      return count;
+    }
+
+    template < typename T >
+    void MakeHeader (unsigned char* h, uint64_t count)
+    {
+      std::memset(h, 0, header_size);
+      std::memcpy(h, magic, 4);
+      h[4] = version;
+      h[5] = (unsigned char)sizeof(T);
+      h[6] = KindOf<T>::value;
+      PutCount(h, count);
+    }
+
+    inline bool IsHeader (const unsigned char* h, size_t bytes)
+    {
+      return bytes >= header_size && std::memcmp(h, magic, 4) == 0;
+    }
+
+    inline bool IsSpace (char c) { return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\f' || c == '\v'; }
+
+  } // namespace binio
+
+  // Parses an integer at [first, last): an optional '-' (signed types
+  // only; '+' is not accepted), then decimal digits. Returns one past the
+  // last character used, or first if there is no number there or it is
+  // out of range for T, in which case value is unchanged.
+  template < typename T >
+  const char* ParseNumber (const char* first, const char* last, T& value)
+  {
+    static_assert(std::is_integral<T>::value, "ParseNumber: integer types only");
+    typedef typename std::make_unsigned<T>::type U;
+    const char* p   = first;
+    bool        neg = 0;
+    if (std::is_signed<T>::value && p != last && *p == '-')
+    {
+      neg = 1;
+      ++p;
+    }
+    const char* digits = p;
+    U max = neg ? (U)((U)1 << (8 * sizeof(T) - 1))  // |min|
+                : (U)(std::is_signed<T>::value ? ((U)1 << (8 * sizeof(T) - 1)) - 1 : ~(U)0);
+    U x = 0;
+    for (; p != last && (unsigned)(*p - '0') < 10; ++p)
+    {
+      U d = (U)(*p - '0');
+      if (x > (U)((max - d) / 10)) // x * 10 + d > max
+        return first;
+      x = (U)(x * 10 + d);
+    }
+    if (p == digits)
+      return first;
+    value = neg ? (T)(0 - x) : (T)x;
+    return p;
+  }
+
+  // Writes x in decimal at first, which has room for at least 20
+  // characters (21 for signed types). Returns one past the last character.
+  template < typename T >
+  char* FormatNumber (char* first, T x)
+  {
+    static_assert(std::is_integral<T>::value, "FormatNumber: integer types only");
+    typedef typename std::make_unsigned<T>::type U;
+    U u = (U)x;
+    if (std::is_signed<T>::value && x < 0)
+    {
+      *first++ = '-';
+      u = (U)(0 - u);
+    }
+    char  digits [20];
+    char* d = digits + 20;
+    do
+    {
+      *--d = (char)('0' + u % 10);
+      u /= 10;
+    }
+    while (u != 0);
+    size_t n = digits + 20 - d;
+    std::memcpy(first, d, n);
+    return first + n;
+  }
+
+  template < typename T >
+  class NumberFile
+  {
+  public:
+    NumberFile () : data_(0), size_(0), map_(0), mapBytes_(0), format_(format_auto) {}
+    ~NumberFile () { Close(); }
+
+    bool Open (const char* name, NumberFormat format = format_auto)
+    {
+      Close();
+      error_.clear();
+      int fd = ::open(name, O_RDONLY);
+      if (fd < 0)
+        return Fail(std::string("cannot open ") + name);
+      struct stat st;
+      if (::fstat(fd, &st) != 0)
+      {
+        ::close(fd);
+        return Fail(std::string("cannot read ") + name);
+      }
+      size_t bytes = (size_t)st.st_size;
+      if (bytes > 0)
+      {
+        void* m = ::mmap(0, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (m == MAP_FAILED)
+        {
+          ::close(fd);
+          return Fail(std::string("cannot map ") + name);
+        }
+        map_      = m;
+        mapBytes_ = bytes;
+        ::madvise(map_, mapBytes_, MADV_SEQUENTIAL);
+      }
+      ::close(fd); // the mapping stays
+      const unsigned char* h = (const unsigned char*)map_;
+      if (format == format_auto)
+        format = binio::IsHeader(h, bytes) ? format_binary : format_text;
+      format_ = format;
+      bool ok = (format == format_binary) ? Binary(name, h, bytes)
+                                          : Text(name, (const char*)map_, bytes, std::is_integral<T>());
+      if (!ok)
+      {
+        Unmap();
+        data_ = 0; size_ = 0;
+      }
+      return ok;
+    }
+
+    void Close ()
+    {
+      Unmap();
+      std::vector<T>().swap(owned_);
+      data_   = 0;
+      size_   = 0;
+      format_ = format_auto;
+    }
+
+    const T*     Begin      ()         const { return data_; }
+    const T*     End        ()         const { return data_ + size_; }
+    size_t       Size       ()         const { return size_; }
+    const T&     operator [](size_t i) const { return data_[i]; }
+    NumberFormat Format     ()         const { return format_; }
+    bool         Mapped     ()         const { return data_ != 0 && owned_.empty(); } // points into the file
+    const std::string& Error ()        const { return error_; }
+
+  private:
+    bool Fail (const std::string& message)
+    {
+      error_ = message;
+      return 0;
+    }
+
+    void Unmap ()
+    {
+      if (map_) ::munmap(map_, mapBytes_);
+      map_ = 0; mapBytes_ = 0;
+    }
+
+    bool Binary (const char* name, const unsigned char* h, size_t bytes)
+    {
+      if (!binio::IsHeader(h, bytes))
+        return Fail(std::string(name) + " is not a binary number file");
+      if (h[4] != binio::version)
+        return Fail(std::string(name) + ": unknown version " + std::to_string((unsigned)h[4]));
+      if (h[5] != sizeof(T) || h[6] != binio::KindOf<T>::value)
+        return Fail(std::string(name) + " holds " + std::to_string((unsigned)h[5]) + "-byte "
+                    + binio::KindName(h[6]) + " numbers, not " + std::to_string(sizeof(T)) + "-byte "
+                    + binio::KindName(binio::KindOf<T>::value));
+      uint64_t count = binio::GetCount(h);
+      if (count > (bytes - binio::header_size) / sizeof(T))
+        return Fail(std::string(name) + " is shorter than its header says");
+      size_ = (size_t)count;
+      if (binio::LittleEndian())
+      {
+        data_ = (const T*)(h + binio::header_size);
+        return 1;
+      }
+      owned_.resize(size_);
+      std::memcpy(owned_.data(), h + binio::header_size, size_ * sizeof(T));
+      binio::SwapBytes(owned_.data(), size_, sizeof(T));
+      Unmap();
+      data_ = owned_.data();
+      return 1;
+    }
+
+    bool Text (const char* name, const char* text, size_t bytes, std::true_type)
+    {
+      const char* p   = text;
+      const char* end = text + bytes;
+      // ranuint's lines are about 11 bytes: one allocation for those
+      owned_.reserve(bytes / 8 + 1);
+      while (1)
+      {
+        while (p != end && binio::IsSpace(*p))
+          ++p;
+        if (p == end)
+          break;
+        T x;
+        const char* q = ParseNumber(p, end, x);
+        if (q == p || (q != end && !binio::IsSpace(*q)))
+          return Fail(std::string(name) + ": not a number at byte " + std::to_string((unsigned long long)(p - text)));
+        owned_.push_back(x);
+        p = q;
+      }
+      Unmap();
+      data_ = owned_.data();
+      size_ = owned_.size();
+      return 1;
+    }
+
+    bool Text (const char* name, const char*, size_t, std::false_type)
+    {
+      return Fail(std::string(name) + ": text is read into integer types only");
+    }
+
+    NumberFile (const NumberFile&);             // disallowed
+    NumberFile& operator = (const NumberFile&); // disallowed
+
+    const T*       data_;
+    size_t         size_;
+    void*          map_;
+    size_t         mapBytes_;
+    std::vector<T> owned_;  // parsed text, or swapped binary
+    NumberFormat   format_;
+    std::string    error_;
+  };
+
+  template < typename T >
+  class NumberWriter
+  {
+  public:
+    NumberWriter () : file_(0), format_(format_text), count_(0), pos_(0) {}
+    ~NumberWriter () { Close(); }
+
+    // format_auto writes text
+    bool Open (const char* name, NumberFormat format)
+    {
+      Close();
+      file_ = std::fopen(name, "wb");
+      if (file_ == 0)
+        return Fail(std::string("cannot open ") + name);
+      name_   = name;
+      error_.clear();
+      format_ = (format == format_binary) ? format_binary : format_text;
+      count_  = 0;
+      pos_    = 0;
+      if (format_ == format_binary)
+      {
+        unsigned char h [binio::header_size];
+        binio::MakeHeader<T>(h, 0); // the count is filled in by Close
+        if (std::fwrite(h, 1, binio::header_size, file_) != binio::header_size)
+          return Fail("cannot write " + name_);
+      }
+      return 1;
+    }
+
+    void Put (T x)
+    {
+      if (format_ == format_binary)
+      {
+        if (pos_ + sizeof(T) > buffer_size) Flush();
+        std::memcpy(buf_ + pos_, &x, sizeof(T));
+        if (!binio::LittleEndian())
+          binio::SwapBytes(buf_ + pos_, 1, sizeof(T));
+        pos_ += sizeof(T);
+      }
+      else
+      {
+        if (pos_ + 32 > buffer_size) Flush();
+        pos_ = Format(buf_ + pos_, x, std::is_integral<T>()) - buf_;
+        buf_[pos_++] = '\n';
+      }
+      ++count_;
+    }
+
+    bool Close ()
+    {
+      if (file_ == 0)
+        return error_.empty();
+      Flush();
+      if (format_ == format_binary)
+      {
+        unsigned char h [binio::header_size];
+        binio::MakeHeader<T>(h, count_);
+        if (std::fseek(file_, 0, SEEK_SET) != 0 || std::fwrite(h, 1, binio::header_size, file_) != binio::header_size)
+          Fail("cannot write " + name_);
+      }
+      if (std::fclose(file_) != 0)
+        Fail("cannot write " + name_);
+      file_ = 0;
+      return error_.empty();
+    }
+
+    // all of a[0,n); text is formatted in parallel on pool, if there is one
+    void Write (const T* a, size_t n, TaskPool* pool = 0)
+    {
+      Flush();
+      if (format_ == format_binary && binio::LittleEndian())
+      {
+        if (std::fwrite(a, sizeof(T), n, file_) != n)
+          Fail("cannot write " + name_);
+        count_ += n;
+        return;
+      }
+      if (format_ == format_binary || pool == 0 || n < 2 * text_block)
+      {
+        for (size_t i = 0; i < n; ++i)
+          Put(a[i]);
+        return;
+      }
+      size_t blocks = 4 * pool->Size();
+      std::vector<std::vector<char>> text(blocks, std::vector<char>(text_block * 32));
+      std::vector<size_t> used(blocks);
+      for (size_t lo = 0; lo < n; lo += blocks * text_block)
+      {
+        TaskGroup group(*pool);
+        for (size_t b = 0; b < blocks && lo + b * text_block < n; ++b)
+          group.Spawn([&, b, lo]()
+          {
+            const T* x   = a + lo + b * text_block;
+            const T* end = (lo + (b + 1) * text_block < n) ? x + text_block : a + n;
+            char* p = text[b].data();
+            for (; x != end; ++x)
+            {
+              p = Format(p, *x, std::is_integral<T>());
+              *p++ = '\n';
+            }
+            used[b] = p - text[b].data();
+          });
+        group.Wait();
+        for (size_t b = 0; b < blocks && lo + b * text_block < n; ++b)
+          if (std::fwrite(text[b].data(), 1, used[b], file_) != used[b])
+            Fail("cannot write " + name_);
+      }
+      count_ += n;
+    }
+
+    uint64_t           Count () const { return count_; }
+    const std::string& Error () const { return error_; }
+
+  private:
+    static const size_t buffer_size = 1 << 16;
+    static const size_t text_block  = 1 << 16; // numbers formatted per task in Write
+
+    bool Fail (const std::string& message)
+    {
+      if (error_.empty()) error_ = message;
+      return 0;
+    }
+
+    static char* Format (char* p, T x, std::true_type) { return FormatNumber(p, x); }
+
+    // enough digits to read back the same value
+    static char* Format (char* p, T x, std::false_type)
+    {
+      return p + std::snprintf(p, 32, "%.*g", (sizeof(T) == 4) ? 9 : 17, (double)x);
+    }
+
+    void Flush ()
+    {
+      if (pos_ > 0 && std::fwrite(buf_, 1, pos_, file_) != pos_)
+        Fail("cannot write " + name_);
+      pos_ = 0;
+    }
+
+    NumberWriter (const NumberWriter&);             // disallowed
+    NumberWriter& operator = (const NumberWriter&); // disallowed
+
+    FILE*        file_;
+    std::string  name_;
+    NumberFormat format_;
+    uint64_t     count_;
+    size_t       pos_;
+    char         buf_ [buffer_size];
+    std::string  error_;
+  };
+
+} // namespace fsu
+
+#endif
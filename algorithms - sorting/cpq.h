@@ -0,0 +1,262 @@
+/*
+    cpq.h
+    10/19/26
+
+    a concurrent priority queue for many producers and consumers: a
+    MultiQueue of d-ary heaps (gheap.h)
+
+      fsu::MultiQueue < Job , JobLess > q;            // relaxed, 2 heaps per thread
+      q.Push(job);                                   // any thread
+      Job j; if (q.TryPop(j)) Run(j);                // any thread
+
+    One heap behind one mutex takes every push and pop in turn, however
+    many threads there are. A MultiQueue has c heaps, each with its own
+    lock, and a thread takes whichever lock it can get:
+
+      Push locks a heap chosen at random, trying others while the chosen
+      one is busy, and pushes there (g_push_heap_dary).
+
+      TryPop, relaxed, picks two heaps at random and pops the better of
+      their tops (g_pop_heap_dary): the "power of two choices" keeps what
+      it returns close to the top of the whole queue, on average within
+      O(c) ranks of it, although not the top itself. If both are empty it
+      looks at every heap before it reports the queue empty.
+
+      TryPop, strict, locks all the heaps in order and pops the best top of
+      them all, so pops come out exactly in order and are linearizable.
+      Pushes still go to one heap each and run in parallel with one
+      another; pops are serialized, so strict mode pays off when pushes
+      outnumber pops or come in bursts.
+
+    The order is that of gheap.h: P is "less than" and the largest comes
+    first. P is copied into each heap and called under that heap's lock
+    only. Size is a count kept on the side and exact only when the queue is
+    quiet. T must be movable; nothing here throws but an allocation.
+*/
+
+#ifndef _CPQ_H
+#define _CPQ_H
+
+#include <cstdlib>   // size_t
+#include <cstdint>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <functional> // std::hash
+#include <compare.h>
+#include <gheap.h>
+
+namespace fsu
+{
+
+  enum PopMode { pop_relaxed, pop_strict };
+
+  template < typename T , class P = LessThan<T> , size_t D = 4 >
+  class MultiQueue
+  {
+  public:
+    // queues = 0 means two per hardware thread
+    explicit MultiQueue (size_t queues = 0, PopMode mode = pop_relaxed, const P& pred = P());
+    ~MultiQueue ();
+
+    void    Push   (const T& t);
+    void    Push   (T&& t);
+    bool    TryPop (T& t);     // false if the queue was seen empty
+    size_t  Size   () const { return size_.load(std::memory_order_relaxed); }
+    bool    Empty  () const { return Size() == 0; }
+    size_t  Queues () const { return heaps_.size(); }
+    PopMode Mode   () const { return mode_; }
+
+  private:
+    struct Heap
+    {
+      std::mutex     mutex;
+      std::vector<T> items; // a D-ary POT
+      P              pred;
+      char           pad [64]; // keeps the next heap's lock off this cache line
+
+      explicit Heap (const P& p) : pred(p) {}
+    };
+
+    template < typename U >
+    void   PushAny    (U&& t);
+    bool   PopRelaxed (T& t);
+    bool   PopStrict  (T& t);
+    void   PopFrom    (Heap& h, T& t); // Pre: h is locked and not empty
+    size_t Pick       ();              // a heap at random
+
+    MultiQueue (const MultiQueue&);             // disallowed
+    MultiQueue& operator = (const MultiQueue&); // disallowed
+
+    std::vector<Heap*>  heaps_;
+    PopMode             mode_;
+    std::atomic<size_t> size_;
+  };
+
+  namespace cpq
+  {
+
+    // the next of a thread's SplitMix64 stream, seeded from its id
+    inline uint64_t Random ()
+    {
+      static thread_local uint64_t state = std::hash<std::thread::id>()(std::this_thread::get_id());
+      uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+      z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+      z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+      return z ^ (z >> 31);
+    }
+
+  } // namespace cpq
+
+  //-------------------------------------
+  // MultiQueue <T,P,D>
+  //-------------------------------------
+
+  template < typename T , class P , size_t D >
+  MultiQueue<T,P,D>::MultiQueue (size_t queues, PopMode mode, const P& pred)
+    : heaps_(), mode_(mode), size_(0)
+  {
+    if (queues == 0)
+    {
+      size_t threads = std::thread::hardware_concurrency();
+      queues = 2 * (threads ? threads : 1);
+    }
+    for (size_t i = 0; i < queues; ++i)
+      heaps_.push_back(new Heap(pred));
+  }
+
+  template < typename T , class P , size_t D >
+  MultiQueue<T,P,D>::~MultiQueue ()
+  {
+    for (size_t i = 0; i < heaps_.size(); ++i)
+      delete heaps_[i];
+  }
+
+  template < typename T , class P , size_t D >
+  void MultiQueue<T,P,D>::Push (const T& t)
+  {
+    PushAny(t);
+  }
+
+  template < typename T , class P , size_t D >
+  void MultiQueue<T,P,D>::Push (T&& t)
+  {
+    PushAny(std::move(t));
+  }
+
+  template < typename T , class P , size_t D >
+  template < typename U >
+  void MultiQueue<T,P,D>::PushAny (U&& t)
+  {
+    size_t i = Pick();
+    for (size_t tries = 0; !heaps_[i]->mutex.try_lock(); ++tries)
+    {
+      if (tries == heaps_.size()) // all busy, it seems: wait for one
+      {
+        heaps_[i]->mutex.lock();
+        break;
+      }
+      i = Pick();
+    }
+    Heap& h = *heaps_[i];
+    h.items.push_back(std::forward<U>(t));
+    g_push_heap_dary<D>(h.items.begin(), h.items.end(), h.pred);
+    size_.fetch_add(1, std::memory_order_relaxed);
+    h.mutex.unlock();
+  }
+
+  template < typename T , class P , size_t D >
+  bool MultiQueue<T,P,D>::TryPop (T& t)
+  {
+    return mode_ == pop_strict ? PopStrict(t) : PopRelaxed(t);
+  }
+
+  template < typename T , class P , size_t D >
+  bool MultiQueue<T,P,D>::PopRelaxed (T& t)
+  {
+    size_t c = heaps_.size();
+    if (c > 1)
+    {
+      for (size_t tries = 0; tries < c; ++tries)
+      {
+        size_t i = Pick(), j = Pick();
+        if (i == j)
+          j = (i + 1) % c;
+        if (i > j)
+          std::swap(i, j);
+        Heap& a = *heaps_[i];
+        Heap& b = *heaps_[j];
+        if (!a.mutex.try_lock())
+          continue;
+        if (!b.mutex.try_lock())
+        {
+          a.mutex.unlock();
+          continue;
+        }
+        Heap* best = 0;
+        if (!a.items.empty())
+          best = &a;
+        if (!b.items.empty() && (best == 0 || a.pred(a.items[0], b.items[0])))
+          best = &b;
+        if (best)
+          PopFrom(*best, t);
+        b.mutex.unlock();
+        a.mutex.unlock();
+        if (best)
+          return 1;
+        if (Empty())
+          return 0;
+      }
+    }
+    // both empty or both busy, time after time: any heap that has something
+    for (size_t k = 0, i = Pick(); k < c; ++k, i = (i + 1) % c)
+    {
+      Heap& h = *heaps_[i];
+      std::lock_guard < std::mutex > lock(h.mutex);
+      if (!h.items.empty())
+      {
+        PopFrom(h, t);
+        return 1;
+      }
+    }
+    return 0;
+  }
+
+  template < typename T , class P , size_t D >
+  bool MultiQueue<T,P,D>::PopStrict (T& t)
+  {
+    for (size_t i = 0; i < heaps_.size(); ++i) // in order: no deadlock
+      heaps_[i]->mutex.lock();
+    Heap* best = 0;
+    for (size_t i = 0; i < heaps_.size(); ++i)
+    {
+      Heap& h = *heaps_[i];
+      if (!h.items.empty() && (best == 0 || h.pred(best->items[0], h.items[0])))
+        best = &h;
+    }
+    if (best)
+      PopFrom(*best, t);
+    for (size_t i = heaps_.size(); i > 0; --i)
+      heaps_[i - 1]->mutex.unlock();
+    return best != 0;
+  }
+
+  template < typename T , class P , size_t D >
+  void MultiQueue<T,P,D>::PopFrom (Heap& h, T& t)
+  {
+    g_pop_heap_dary<D>(h.items.begin(), h.items.end(), h.pred);
+    t = std::move(h.items.back());
+    h.items.pop_back();
+    size_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  template < typename T , class P , size_t D >
+  size_t MultiQueue<T,P,D>::Pick ()
+  {
+    return (size_t)(cpq::Random() % heaps_.size());
+  }
+
+} // namespace fsu
+
+#endif
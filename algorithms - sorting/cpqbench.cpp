@@ -0,0 +1,213 @@
+/*
+    cpqbench.cpp
+    10/19/26
+
+    throughput of the concurrent priority queues (cpq.h) against one heap
+    behind one mutex, for numbers of producer and consumer threads
+
+      cpqbench.x producers=1,2,4 consumers=1,2,4 ops=1000000 queues=0 reps=3
+
+    Each run pushes ops random 64-bit keys, split among the producers, and
+    the consumers pop until the producers are done and the queue is empty.
+    The time is from the start of all threads to the end of the last; the
+    rate counts pushes and pops, 2 * ops per run. The median of reps runs
+    is reported. queues=0 is the MultiQueue default, two per hardware
+    thread.
+
+      mutex_heap  g_push_heap / g_pop_heap on one vector, one mutex
+      mq_strict   MultiQueue, pop_strict
+      mq_relaxed  MultiQueue, pop_relaxed
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+
+#include <compare.h>
+#include <gheap.h>
+#include <cpq.h>
+#include <sortbench.h> // ParseCounts, SplitArgument, Summarize
+
+typedef uint64_t KeyType;
+
+// the baseline: what a dispatcher with one lock does
+class MutexHeap
+{
+public:
+  void Push (const KeyType& k)
+  {
+    std::lock_guard < std::mutex > lock(mutex_);
+    items_.push_back(k);
+    fsu::g_push_heap(items_.begin(), items_.end(), lt_);
+  }
+
+  bool TryPop (KeyType& k)
+  {
+    std::lock_guard < std::mutex > lock(mutex_);
+    if (items_.empty())
+      return 0;
+    fsu::g_pop_heap(items_.begin(), items_.end(), lt_);
+    k = items_.back();
+    items_.pop_back();
+    return 1;
+  }
+
+private:
+  std::mutex                      mutex_;
+  std::vector<KeyType>            items_;
+  fsu::LessThan<KeyType>          lt_;
+};
+
+// SplitMix64's output function, for the keys
+inline KeyType Key (uint64_t i)
+{
+  uint64_t z = (i + 1) * 0x9E3779B97F4A7C15ull;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  return z ^ (z >> 31);
+}
+
+// seconds for one run; popped is what the consumers got, all told
+template < class Q >
+double Run (Q& q, size_t producers, size_t consumers, size_t ops, size_t& popped)
+{
+  std::atomic<bool>   go(0);
+  std::atomic<size_t> done(0);   // producers finished
+  std::atomic<size_t> total(0);  // pops, added at the end of each consumer
+  std::vector < std::thread > threads;
+
+  for (size_t p = 0; p < producers; ++p)
+    threads.push_back(std::thread([&, p]()
+    {
+      while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+      for (size_t i = ops * p / producers; i < ops * (p + 1) / producers; ++i)
+        q.Push(Key(i));
+      done.fetch_add(1, std::memory_order_release);
+    }));
+  for (size_t c = 0; c < consumers; ++c)
+    threads.push_back(std::thread([&]()
+    {
+      while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+      size_t count = 0;
+      KeyType k;
+      for (;;)
+      {
+        if (q.TryPop(k))
+          ++count;
+        else if (done.load(std::memory_order_acquire) == producers)
+        {
+          if (!q.TryPop(k)) break; // nothing more will come
+          ++count;
+        }
+        else
+          std::this_thread::yield();
+      }
+      total.fetch_add(count);
+    }));
+
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  go.store(1, std::memory_order_release);
+  for (size_t i = 0; i < threads.size(); ++i)
+    threads[i].join();
+  std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+  popped = total.load();
+  return std::chrono::duration < double > (stop - start).count();
+}
+
+const size_t c1 = 12, c2 = 11, c3 = 11, c4 = 11, c5 = 10, c6 = 10, c7 = 8;
+
+void Row (const char* name, size_t producers, size_t consumers, size_t queues,
+          size_t ops, std::vector < double >& usec, bool ok)
+{
+  double median = fsu::Summarize(usec).median / 1e6; // seconds
+  std::cout << ' ' << std::left << std::setw(c1) << name << std::right
+            << std::setw(c2) << producers
+            << std::setw(c3) << consumers
+            << std::setw(c4);
+  if (queues) std::cout << queues; else std::cout << '-';
+  std::cout << std::setw(c5) << std::fixed << std::setprecision(1) << median * 1000
+            << std::setw(c6) << std::setprecision(2) << 2 * ops / median / 1e6
+            << std::setw(c7) << (ok ? "" : "LOST") << '\n';
+}
+
+int main (int argc, char* argv[])
+{
+  std::vector < size_t > producers(1, 1), consumers(1, 1);
+  producers.push_back(2); producers.push_back(4);
+  consumers.push_back(2); consumers.push_back(4);
+  size_t ops = 1000000, queues = 0, reps = 3;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string name;
+    const char* value = fsu::SplitArgument(argv[i], name);
+    bool ok = (value != 0);
+    if      (!ok)                      ;
+    else if (name == "producers")      ok = fsu::ParseCounts(value, producers);
+    else if (name == "consumers")      ok = fsu::ParseCounts(value, consumers);
+    else if (name == "ops")            ok = (ops = std::strtoull(value, 0, 10)) > 0;
+    else if (name == "queues")         queues = std::strtoull(value, 0, 10);
+    else if (name == "reps")           ok = (reps = std::strtoull(value, 0, 10)) > 0;
+    else                               ok = 0;
+    if (!ok)
+    {
+      fsu::BadArgument(std::cout, argv[i], "producers=1,2,4 consumers=1,2,4 ops=1000000 queues=0 reps=3");
+      return 0;
+    }
+  }
+
+  std::cout << "\n Priority queue throughput: " << ops << " pushes and pops per run, median of "
+            << reps << ", " << std::thread::hardware_concurrency() << " hardware threads\n\n"
+            << ' ' << std::left << std::setw(c1) << "queue" << std::right
+            << std::setw(c2) << "producers"
+            << std::setw(c3) << "consumers"
+            << std::setw(c4) << "heaps"
+            << std::setw(c5) << "msec"
+            << std::setw(c6) << "Mops/s" << '\n'
+            << ' ';
+  for (size_t i = 0; i < c1+c2+c3+c4+c5+c6; ++i) std::cout << '-';
+  std::cout << '\n';
+
+  for (size_t pi = 0; pi < producers.size(); ++pi)
+    for (size_t ci = 0; ci < consumers.size(); ++ci)
+    {
+      size_t p = producers[pi], c = consumers[ci], popped;
+      std::vector < double > usec;
+      bool ok = 1;
+
+      for (size_t r = 0; r < reps; ++r)
+      {
+        MutexHeap q;
+        usec.push_back(Run(q, p, c, ops, popped) * 1e6);
+        ok = ok && popped == ops;
+      }
+      Row("mutex_heap", p, c, 0, ops, usec, ok);
+
+      for (size_t m = 0; m < 2; ++m)
+      {
+        fsu::PopMode mode = m ? fsu::pop_relaxed : fsu::pop_strict;
+        size_t heaps = 0;
+        usec.clear();
+        ok = 1;
+        for (size_t r = 0; r < reps; ++r)
+        {
+          fsu::MultiQueue < KeyType > q(queues, mode);
+          heaps = q.Queues();
+          usec.push_back(Run(q, p, c, ops, popped) * 1e6);
+          ok = ok && popped == ops;
+        }
+        Row(m ? "mq_relaxed" : "mq_strict", p, c, heaps, ops, usec, ok);
+      }
+    }
+  std::cout << '\n';
+  return 0;
+}
@@ -0,0 +1,394 @@
+/*
+    datagen.h
+    10/19/26
+
+    test data in the shapes that real inputs have
+
+      fsu::DataSpec spec;                        // uniform over all of T, seed 1
+      spec.shape = fsu::shape_zipf;
+      fsu::generate_data (A, n, spec [, pool]);  // on TaskPool::Default() if no pool
+      fsu::anti_quicksort (A, n, sort);          // McIlroy's adversary for one sort
+
+    Shapes, for integer T, with values in [0, spec.bound) (0: all of T's
+    non-negative range) and spec.k a shape parameter (0: the default given):
+
+      uniform       independent uniform values
+      sorted        uniform values, ascending
+      reverse       uniform values, descending
+      nearly_sorted sorted, then k random pairs swapped (default n / 1000 + 1)
+      organ_pipe    rising to the middle, then falling, in even steps
+      sawtooth      k rising ramps (default 16)
+      few_unique    k distinct random values (default 16), uniformly mixed
+      zipf          value r - 1 with probability proportional to 1 / r^s,
+                    r = 1 .. bound, s = spec.s (default 1): 0 is the most
+                    common value, 1 the next, and so on
+      equal         one random value n times
+
+    Element i is a function of spec.seed and i only: every element is
+    drawn from a counter-based generator (the SplitMix64 output function
+    applied to seed and position), so blocks of the array are generated
+    in parallel on a TaskPool and the output is the same for a given seed
+    whatever the number of threads. The sorted shapes are made by
+    radix_sort (rsort.h) of uniform values. Zipf values are drawn by
+    rejection-inversion (Hormann and Derflinger), a constant expected
+    number of draws per value for any bound.
+
+    anti_quicksort makes the input that drives one particular sort to its
+    worst case, after McIlroy, "A Killer Adversary for Quicksort" (1999).
+    It runs the sort on indices with a comparison that decides the values
+    as the sort asks about them: every item starts as "gas" (greater than
+    every solid value, equal to other gas), and when two gas items are
+    compared one of them is frozen to the next solid value, chosen so that
+    the pivot candidate freezes low. The values decided by the end are the
+    input. The sort must be deterministic (no random pivots), and making
+    the input takes as long as the sort it defeats: Theta(n^2) for a
+    quicksort that falls for it.
+*/
+
+#ifndef _DATAGEN_H
+#define _DATAGEN_H
+
+#include <cstdlib>   // size_t
+#include <cstdint>
+#include <cstring>   // strcmp
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <type_traits>
+#include <rsort.h>   // radix_sort
+#include <tpool.h>
+
+namespace fsu
+{
+
+  enum DataShape { shape_uniform, shape_sorted, shape_reverse, shape_nearly_sorted, shape_organ_pipe,
+                   shape_sawtooth, shape_few_unique, shape_zipf, shape_equal };
+
+  struct DataSpec
+  {
+    DataShape shape;
+    uint64_t  bound; // values in [0, bound); 0: all non-negative values of T
+    uint64_t  k;     // swaps, teeth or distinct values; 0: the shape's default
+    double    s;     // Zipf exponent
+    uint64_t  seed;
+
+    DataSpec () : shape(shape_uniform), bound(0), k(0), s(1.0), seed(1) {}
+  };
+
+  namespace datagen
+  {
+
+    const size_t grain = 65536; // elements per task
+
+    const char* const shape_names [] = { "uniform", "sorted", "reverse", "nearly_sorted", "organ_pipe",
+                                         "sawtooth", "few_unique", "zipf", "equal" };
+    const size_t shape_count = sizeof(shape_names) / sizeof(shape_names[0]);
+
+    // SplitMix64's output function: a bijection that scrambles every bit
+    inline uint64_t Mix (uint64_t z)
+    {
+      z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+      z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+      return z ^ (z >> 31);
+    }
+
+    // draw i of the stream named by seed and tag
+    inline uint64_t Draw (uint64_t seed, uint64_t tag, uint64_t i)
+    {
+      return Mix(Mix(seed ^ (tag * 0xD1B54A32D192ED03ull)) + (i + 1) * 0x9E3779B97F4A7C15ull);
+    }
+
+    // r scaled into [0, bound), without the bias of r % bound
+    inline uint64_t Below (uint64_t r, uint64_t bound)
+    {
+#ifdef __SIZEOF_INT128__
+      return (uint64_t)(((unsigned __int128)r * bound) >> 64);
+#else
+      return r % bound;
+#endif
+    }
+
+    // x * bound / m, for x < m
+    inline uint64_t Scale (uint64_t x, uint64_t m, uint64_t bound)
+    {
+#ifdef __SIZEOF_INT128__
+      return (uint64_t)(((unsigned __int128)x * bound) / m);
+#else
+      return (uint64_t)((double)x / m * bound);
+#endif
+    }
+
+    inline double Unit (uint64_t r) { return (r >> 11) * (1.0 / 9007199254740992.0); } // [0, 1)
+
+    // rejection-inversion sampling of the Zipf distribution on 1 .. n
+    class Zipf
+    {
+    public:
+      Zipf (uint64_t n, double s) : n_((double)n), s_(s)
+      {
+        hx1_   = H(1.5) - 1.0;
+        hn_    = H(n_ + 0.5);
+        shift_ = 2.0 - HInverse(H(2.5) - h(2.0));
+      }
+
+      // value i: draw i of the stream seed, tag, and if that is rejected,
+      // the draws of a stream of i's own, seeded from draw i of seed, retry,
+      // so no retry is a draw that another value uses, for any n
+      uint64_t operator () (uint64_t seed, uint64_t tag, uint64_t retry, uint64_t i) const
+      {
+        uint64_t r = Draw(seed, tag, i), own = 0;
+        for (uint64_t j = 0; ; r = Draw(own, retry, j++))
+        {
+          double u = hn_ + Unit(r) * (hx1_ - hn_);
+          double x = HInverse(u);
+          double k = std::floor(x + 0.5);
+          if (k < 1)   k = 1;
+          if (k > n_)  k = n_;
+          if (k - x <= shift_ || u >= H(k + 0.5) - h(k))
+            return (uint64_t)k;
+          if (j == 0)
+            own = Draw(seed, retry, i);
+        }
+      }
+
+    private:
+      double h (double x) const { return std::exp(-s_ * std::log(x)); }
+
+      double H (double x) const // integral of h, shifted
+      {
+        double lx = std::log(x);
+        return Helper2((1.0 - s_) * lx) * lx;
+      }
+
+      double HInverse (double x) const
+      {
+        double t = x * (1.0 - s_);
+        if (t < -1.0) t = -1.0;
+        return std::exp(Helper1(t) * x);
+      }
+
+      static double Helper1 (double x) // log(1 + x) / x
+      {
+        return (std::fabs(x) > 1e-8) ? std::log1p(x) / x : 1.0 - x * (0.5 - x * (1.0 / 3.0 - 0.25 * x));
+      }
+
+      static double Helper2 (double x) // (exp(x) - 1) / x
+      {
+        return (std::fabs(x) > 1e-8) ? std::expm1(x) / x : 1.0 + x * 0.5 * (1.0 + x / 3.0 * (1.0 + 0.25 * x));
+      }
+
+      double n_, s_, hx1_, hn_, shift_;
+    };
+
+    // runs f(lo, hi) over [0, n) in blocks, on the pool when there is more than one
+    template < class F >
+    void ForBlocks (size_t n, TaskPool* pool, F f)
+    {
+      if (pool == 0 || n <= grain)
+      {
+        f((size_t)0, n);
+        return;
+      }
+      TaskGroup group(*pool);
+      for (size_t lo = 0; lo < n; lo += grain)
+      {
+        size_t hi = (lo + grain < n) ? lo + grain : n;
+        group.Spawn([&f, lo, hi]() { f(lo, hi); });
+      }
+      group.Wait();
+    }
+
+    // stream tags: independent draws for each use
+    enum Tag { tag_value, tag_swap, tag_key, tag_zipf, tag_zipf_retry };
+
+  } // namespace datagen
+
+  inline const char* DataShapeName (DataShape shape)
+  {
+    return ((size_t)shape < datagen::shape_count) ? datagen::shape_names[shape] : "unknown";
+  }
+
+  // false if name is not one of the shapes
+  inline bool ParseDataShape (const char* name, DataShape& shape)
+  {
+    for (size_t i = 0; i < datagen::shape_count; ++i)
+      if (std::strcmp(name, datagen::shape_names[i]) == 0)
+      {
+        shape = (DataShape)i;
+        return 1;
+      }
+    return 0;
+  }
+
+  namespace datagen
+  {
+
+    // pool may be 0: the calling thread only
+    template < typename T >
+    void Generate (T* a, size_t n, const DataSpec& spec, TaskPool* pool)
+    {
+      if (n == 0) return;
+      uint64_t bound = spec.bound;
+      if (bound == 0 || bound > (uint64_t)std::numeric_limits<T>::max())
+        bound = (uint64_t)std::numeric_limits<T>::max(); // as ranuint: 0 .. max - 1
+      uint64_t seed = spec.seed;
+      uint64_t k    = spec.k;
+      switch (spec.shape)
+      {
+        case shape_uniform:
+        case shape_sorted:
+        case shape_reverse:
+        case shape_nearly_sorted:
+          ForBlocks(n, pool, [=](size_t lo, size_t hi)
+          {
+            for (size_t i = lo; i < hi; ++i)
+              a[i] = (T)Below(Draw(seed, tag_value, i), bound);
+          });
+          if (spec.shape == shape_uniform)
+            break;
+          if (pool) radix_sort(a, n, *pool);
+          else      radix_sort(a, n);
+          if (spec.shape == shape_reverse)
+            for (size_t i = 0, j = n - 1; i < j; ++i, --j)
+            {
+              T t = a[i]; a[i] = a[j]; a[j] = t;
+            }
+          if (spec.shape == shape_nearly_sorted)
+          {
+            if (k == 0) k = n / 1000 + 1;
+            for (uint64_t j = 0; j < k; ++j)
+            {
+              size_t x = (size_t)Below(Draw(seed, tag_swap, 2 * j), n);
+              size_t y = (size_t)Below(Draw(seed, tag_swap, 2 * j + 1), n);
+              T t = a[x]; a[x] = a[y]; a[y] = t;
+            }
+          }
+          break;
+
+        case shape_organ_pipe:
+        {
+          uint64_t m = (n + 1) / 2; // steps up
+          ForBlocks(n, pool, [=](size_t lo, size_t hi)
+          {
+            for (size_t i = lo; i < hi; ++i)
+              a[i] = (T)Scale((i < m) ? i : n - 1 - i, m, bound);
+          });
+          break;
+        }
+
+        case shape_sawtooth:
+        {
+          if (k == 0) k = 16;
+          uint64_t period = (n + k - 1) / k;
+          ForBlocks(n, pool, [=](size_t lo, size_t hi)
+          {
+            for (size_t i = lo; i < hi; ++i)
+              a[i] = (T)Scale(i % period, period, bound);
+          });
+          break;
+        }
+
+        case shape_few_unique:
+          if (k == 0) k = 16;
+          ForBlocks(n, pool, [=](size_t lo, size_t hi)
+          {
+            for (size_t i = lo; i < hi; ++i)
+              a[i] = (T)Below(Draw(seed, tag_key, Below(Draw(seed, tag_value, i), k)), bound);
+          });
+          break;
+
+        case shape_zipf:
+        {
+          Zipf zipf(bound, spec.s);
+          ForBlocks(n, pool, [=, &zipf](size_t lo, size_t hi)
+          {
+            for (size_t i = lo; i < hi; ++i)
+              a[i] = (T)(zipf(seed, tag_zipf, tag_zipf_retry, i) - 1);
+          });
+          break;
+        }
+
+        case shape_equal:
+        {
+          T v = (T)Below(Draw(seed, tag_value, 0), bound);
+          ForBlocks(n, pool, [=](size_t lo, size_t hi)
+          {
+            for (size_t i = lo; i < hi; ++i)
+              a[i] = v;
+          });
+          break;
+        }
+      }
+    }
+
+  } // namespace datagen
+
+  template < typename T >
+  void generate_data (T* a, size_t n, const DataSpec& spec, TaskPool& pool)
+  {
+    static_assert(std::is_integral<T>::value && !std::is_same<T,bool>::value, "generate_data: integer types only");
+    datagen::Generate(a, n, spec, &pool);
+  }
+
+  template < typename T >
+  void generate_data (T* a, size_t n, const DataSpec& spec)
+  {
+    static_assert(std::is_integral<T>::value && !std::is_same<T,bool>::value, "generate_data: integer types only");
+    // one block needs no pool: do not start the default one for it
+    datagen::Generate(a, n, spec, (n > datagen::grain) ? &TaskPool::Default() : 0);
+  }
+
+  namespace datagen
+  {
+
+    struct AdversaryState
+    {
+      std::vector<size_t> val;
+      size_t              gas;       // the value of every item not yet frozen: above all solid values
+      size_t              solid;     // the next solid value
+      size_t              candidate; // the gas item most recently compared: likely the pivot
+
+      explicit AdversaryState (size_t n) : val(n, n), gas(n), solid(0), candidate(0) {}
+    };
+
+    // McIlroy's comparison: decides values as the sort asks about them.
+    // The state is shared, so the sort may copy the predicate.
+    class Adversary
+    {
+    public:
+      explicit Adversary (AdversaryState& state) : s_(&state) {}
+
+      bool operator () (size_t x, size_t y) const
+      {
+        AdversaryState& s = *s_;
+        if (s.val[x] == s.gas && s.val[y] == s.gas)
+          s.val[(x == s.candidate) ? x : y] = s.solid++;
+        if (s.val[x] == s.gas)      s.candidate = x;
+        else if (s.val[y] == s.gas) s.candidate = y;
+        return s.val[x] < s.val[y];
+      }
+
+    private:
+      AdversaryState* s_;
+    };
+
+  } // namespace datagen
+
+  // sort(beg, end, cmp) is the sort to defeat, called on size_t*
+  template < typename T , class Sort >
+  void anti_quicksort (T* a, size_t n, Sort sort)
+  {
+    datagen::AdversaryState state(n);
+    std::vector<size_t>     ptr(n);
+    for (size_t i = 0; i < n; ++i)
+      ptr[i] = i;
+    datagen::Adversary cmp(state);
+    if (n > 0)
+      sort(ptr.data(), ptr.data() + n, cmp);
+    for (size_t i = 0; i < n; ++i)
+      a[i] = (T)((state.val[i] == state.gas) ? state.solid : state.val[i]); // gas: all equal, above the rest
+  }
+
+} // namespace fsu
+
+#endif
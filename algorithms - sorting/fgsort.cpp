@@ -5,8 +5,14 @@
 
     functionality test of generic sort algorithms
 
-    gsort.h: g_selection_sort, g_insertion_sort, g_merge_sort, g_quick_sort 
-    gheap.h: g_heap_sort
+    gsort.h: g_selection_sort, g_insertion_sort, g_merge_sort,
+             g_merge_sort_adaptive, g_quick_sort, g_intro_sort,
+             g_nth_element
+    gsort_par.h: g_parallel_merge_sort, g_parallel_quick_sort,
+                 g_parallel_quick_sort_3w
+    gsort_auto.h: g_sort
+    gsort_key.h: g_sort_by_key
+    gheap.h: g_heap_sort, g_heap_sort_dary, g_heap_sort_bu, g_partial_sort
 
     Copyright 2015, R.C. Lacher
 */
@@ -19,11 +25,14 @@
 #include <deque.h>
 #include <list.h>
 #include <genalg.h>
-// #include <gheap.h>
+#include <gheap.h>
 // #include <gheap_basic.h>
-#include <gheap_advanced.h>
+// #include <gheap_advanced.h>
 #include <gheap_cormen.h>
 #include <gsort.h>
+#include <gsort_par.h>
+#include <gsort_auto.h>
+#include <gsort_key.h>
 #include <compare.h>
 #include <insert.h>
 #include <xstring.h>
@@ -33,6 +42,12 @@ typedef char ElementType; const char* e_t = "char"; const char ofc = '\0';
 // #include <xstring.cpp>
 // typedef fsu::String ElementType; const char* e_t = "String"; const char ofc = ' '; 
 
+// key function for g_sort_by_key: the element is its own key
+struct Identity
+{
+  ElementType operator () (const ElementType& e) const { return e; }
+};
+
 void SortHeader (const char* name)
 {
   std::cout << "\n== " << name << " ==\n";
@@ -313,6 +328,98 @@ int main(int argc, char* argv[])
   // Display(L,'L',std::cout,ofc);
   // */
 
+  // g_heap_sort_dary<4>()
+  SortHeader("g_heap_sort_dary<4>()");
+  Restore(L,V,Q,A,inputData);
+  fsu::g_heap_sort_dary<4>(A, A + size);
+  Display(A,size,'A',std::cout,ofc);
+  fsu::g_heap_sort_dary<4>(V.Begin(), V.End());
+  Display(V,'V',std::cout,ofc);
+  fsu::g_heap_sort_dary<4>(Q.Begin(), Q.End());
+  Display(Q,'Q',std::cout,ofc);
+  // fsu::g_heap_sort_dary<4>(L.Begin(), L.End());
+  // Display(L,'L',std::cout,ofc);
+  // */
+
+  // g_heap_sort_dary<8>(>)
+  SortHeader("g_heap_sort_dary<8>(>)");
+  Restore(L,V,Q,A,inputData);
+  fsu::g_heap_sort_dary<8>(A, A + size, gt);
+  Display(A,size,'A',std::cout,ofc);
+  fsu::g_heap_sort_dary<8>(V.Begin(), V.End(), gt);
+  Display(V,'V',std::cout,ofc);
+  fsu::g_heap_sort_dary<8>(Q.Begin(), Q.End(), gt);
+  Display(Q,'Q',std::cout,ofc);
+  // fsu::g_heap_sort_dary<8>(L.Begin(), L.End(), gt);
+  // Display(L,'L',std::cout,ofc);
+  // */
+
+  // g_heap_sort_bu()
+  SortHeader("g_heap_sort_bu()");
+  Restore(L,V,Q,A,inputData);
+  fsu::g_heap_sort_bu(A, A + size);
+  Display(A,size,'A',std::cout,ofc);
+  fsu::g_heap_sort_bu(V.Begin(), V.End());
+  Display(V,'V',std::cout,ofc);
+  fsu::g_heap_sort_bu(Q.Begin(), Q.End());
+  Display(Q,'Q',std::cout,ofc);
+  // fsu::g_heap_sort_bu(L.Begin(), L.End());
+  // Display(L,'L',std::cout,ofc);
+  // */
+
+  // g_heap_sort_bu(>)
+  SortHeader("g_heap_sort_bu(>)");
+  Restore(L,V,Q,A,inputData);
+  fsu::g_heap_sort_bu(A, A + size, gt);
+  Display(A,size,'A',std::cout,ofc);
+  fsu::g_heap_sort_bu(V.Begin(), V.End(), gt);
+  Display(V,'V',std::cout,ofc);
+  fsu::g_heap_sort_bu(Q.Begin(), Q.End(), gt);
+  Display(Q,'Q',std::cout,ofc);
+  // fsu::g_heap_sort_bu(L.Begin(), L.End(), gt);
+  // Display(L,'L',std::cout,ofc);
+  // */
+
+  // g_partial_sort(size/2)
+  SortHeader("g_partial_sort(size/2)");
+  Restore(L,V,Q,A,inputData);
+  fsu::g_partial_sort(A, A + size/2, A + size);
+  Display(A,size,'A',std::cout,ofc);
+  fsu::g_partial_sort(V.Begin(), V.Begin() + size/2, V.End());
+  Display(V,'V',std::cout,ofc);
+  fsu::g_partial_sort(Q.Begin(), Q.Begin() + size/2, Q.End());
+  Display(Q,'Q',std::cout,ofc);
+
+  // g_partial_sort(size/2,>)
+  SortHeader("g_partial_sort(size/2,>)");
+  Restore(L,V,Q,A,inputData);
+  fsu::g_partial_sort(A, A + size/2, A + size, gt);
+  Display(A,size,'A',std::cout,ofc);
+  fsu::g_partial_sort(V.Begin(), V.Begin() + size/2, V.End(), gt);
+  Display(V,'V',std::cout,ofc);
+  fsu::g_partial_sort(Q.Begin(), Q.Begin() + size/2, Q.End(), gt);
+  Display(Q,'Q',std::cout,ofc);
+
+  // g_nth_element(size/2)
+  SortHeader("g_nth_element(size/2)");
+  Restore(L,V,Q,A,inputData);
+  fsu::g_nth_element(A, A + size/2, A + size);
+  Display(A,size,'A',std::cout,ofc);
+  fsu::g_nth_element(V.Begin(), V.Begin() + size/2, V.End());
+  Display(V,'V',std::cout,ofc);
+  fsu::g_nth_element(Q.Begin(), Q.Begin() + size/2, Q.End());
+  Display(Q,'Q',std::cout,ofc);
+
+  // g_nth_element(size/2,>)
+  SortHeader("g_nth_element(size/2,>)");
+  Restore(L,V,Q,A,inputData);
+  fsu::g_nth_element(A, A + size/2, A + size, gt);
+  Display(A,size,'A',std::cout,ofc);
+  fsu::g_nth_element(V.Begin(), V.Begin() + size/2, V.End(), gt);
+  Display(V,'V',std::cout,ofc);
+  fsu::g_nth_element(Q.Begin(), Q.Begin() + size/2, Q.End(), gt);
+  Display(Q,'Q',std::cout,ofc);
+
   // g_merge_sort()
   SortHeader("g_merge_sort()");
   Restore(L,V,Q,A,inputData);
@@ -365,6 +472,32 @@ int main(int argc, char* argv[])
   // Display(L,'L',std::cout,ofc);
   // */
 
+  // g_merge_sort_adaptive()
+  SortHeader("g_merge_sort_adaptive()");
+  Restore(L,V,Q,A,inputData);
+  fsu::g_merge_sort_adaptive(A, A + size);
+  Display(A,size,'A',std::cout,ofc);
+  fsu::g_merge_sort_adaptive(V.Begin(), V.End());
+  Display(V,'V',std::cout,ofc);
+  fsu::g_merge_sort_adaptive(Q.Begin(), Q.End());
+  Display(Q,'Q',std::cout,ofc);
+  // fsu::g_merge_sort_adaptive(L.Begin(), L.End());
+  // Display(L,'L',std::cout,ofc);
+  // */
+
+  // g_merge_sort_adaptive(>)
+  SortHeader("g_merge_sort_adaptive(>)");
+  Restore(L,V,Q,A,inputData);
+  fsu::g_merge_sort_adaptive(A, A + size, gt);
+  Display(A,size,'A',std::cout,ofc);
+  fsu::g_merge_sort_adaptive(V.Begin(), V.End(), gt);
+  Display(V,'V',std::cout,ofc);
+  fsu::g_merge_sort_adaptive(Q.Begin(), Q.End(), gt);
+  Display(Q,'Q',std::cout,ofc);
+  // fsu::g_merge_sort_adaptive(L.Begin(), L.End(), gt);
+  // Display(L,'L',std::cout,ofc);
+  // */
+
   // g_merge_sort_bu()
   SortHeader("g_merge_sort_bu()");
   Restore(L,V,Q,A,inputData);
@@ -391,6 +524,32 @@ int main(int argc, char* argv[])
   // Display(L,'L',std::cout,ofc);
   // */
 
+  // g_parallel_merge_sort()
+  SortHeader("g_parallel_merge_sort()");
+  Restore(L,V,Q,A,inputData);
+  fsu::g_parallel_merge_sort(A, A + size);
+  Display(A,size,'A',std::cout,ofc);
+  fsu::g_parallel_merge_sort(V.Begin(), V.End());
+  Display(V,'V',std::cout,ofc);
+  fsu::g_parallel_merge_sort(Q.Begin(), Q.End());
+  Display(Q,'Q',std::cout,ofc);
+  // fsu::g_parallel_merge_sort(L.Begin(), L.End());
+  // Display(L,'L',std::cout,ofc);
+  // */
+
+  // g_parallel_merge_sort(>)
+  SortHeader("g_parallel_merge_sort(>)");
+  Restore(L,V,Q,A,inputData);
+  fsu::g_parallel_merge_sort(A, A + size, gt);
+  Display(A,size,'A',std::cout,ofc);
+  fsu::g_parallel_merge_sort(V.Begin(), V.End(), gt);
+  Display(V,'V',std::cout,ofc);
+  fsu::g_parallel_merge_sort(Q.Begin(), Q.End(), gt);
+  Display(Q,'Q',std::cout,ofc);
+  // fsu::g_parallel_merge_sort(L.Begin(), L.End(), gt);
+  // Display(L,'L',std::cout,ofc);
+  // */
+
   // g_quick_sort()
   SortHeader("g_quick_sort()");
   Restore(L,V,Q,A,inputData);
@@ -495,6 +654,132 @@ int main(int argc, char* argv[])
   // Display(L,'L',std::cout,ofc);
   // */
 
+  // g_intro_sort()
+  SortHeader("g_intro_sort()");
+  Restore(L,V,Q,A,inputData);
+  fsu::g_intro_sort(A, A + size);
+  Display(A,size,'A',std::cout,ofc);
+  fsu::g_intro_sort(V.Begin(), V.End());
+  Display(V,'V',std::cout,ofc);
+  fsu::g_intro_sort(Q.Begin(), Q.End());
+  Display(Q,'Q',std::cout,ofc);
+  // fsu::g_intro_sort(L.Begin(), L.End());
+  // Display(L,'L',std::cout,ofc);
+  // */
+
+  // g_intro_sort(>)
+  SortHeader("g_intro_sort(>)");
+  Restore(L,V,Q,A,inputData);
+  fsu::g_intro_sort(A, A + size, gt);
+  Display(A,size,'A',std::cout,ofc);
+  fsu::g_intro_sort(V.Begin(), V.End(), gt);
+  Display(V,'V',std::cout,ofc);
+  fsu::g_intro_sort(Q.Begin(), Q.End(), gt);
+  Display(Q,'Q',std::cout,ofc);
+  // fsu::g_intro_sort(L.Begin(), L.End(), gt);
+  // Display(L,'L',std::cout,ofc);
+  // */
+
+  // g_parallel_quick_sort()
+  SortHeader("g_parallel_quick_sort()");
+  Restore(L,V,Q,A,inputData);
+  fsu::g_parallel_quick_sort(A, A + size);
+  Display(A,size,'A',std::cout,ofc);
+  fsu::g_parallel_quick_sort(V.Begin(), V.End());
+  Display(V,'V',std::cout,ofc);
+  fsu::g_parallel_quick_sort(Q.Begin(), Q.End());
+  Display(Q,'Q',std::cout,ofc);
+  // fsu::g_parallel_quick_sort(L.Begin(), L.End());
+  // Display(L,'L',std::cout,ofc);
+  // */
+
+  // g_parallel_quick_sort(>)
+  SortHeader("g_parallel_quick_sort(>)");
+  Restore(L,V,Q,A,inputData);
+  fsu::g_parallel_quick_sort(A, A + size, gt);
+  Display(A,size,'A',std::cout,ofc);
+  fsu::g_parallel_quick_sort(V.Begin(), V.End(), gt);
+  Display(V,'V',std::cout,ofc);
+  fsu::g_parallel_quick_sort(Q.Begin(), Q.End(), gt);
+  Display(Q,'Q',std::cout,ofc);
+  // fsu::g_parallel_quick_sort(L.Begin(), L.End(), gt);
+  // Display(L,'L',std::cout,ofc);
+  // */
+
+  // g_parallel_quick_sort_3w()
+  SortHeader("g_parallel_quick_sort_3w()");
+  Restore(L,V,Q,A,inputData);
+  fsu::g_parallel_quick_sort_3w(A, A + size);
+  Display(A,size,'A',std::cout,ofc);
+  fsu::g_parallel_quick_sort_3w(V.Begin(), V.End());
+  Display(V,'V',std::cout,ofc);
+  fsu::g_parallel_quick_sort_3w(Q.Begin(), Q.End());
+  Display(Q,'Q',std::cout,ofc);
+  // fsu::g_parallel_quick_sort_3w(L.Begin(), L.End());
+  // Display(L,'L',std::cout,ofc);
+  // */
+
+  // g_parallel_quick_sort_3w(>)
+  SortHeader("g_parallel_quick_sort_3w(>)");
+  Restore(L,V,Q,A,inputData);
+  fsu::g_parallel_quick_sort_3w(A, A + size, gt);
+  Display(A,size,'A',std::cout,ofc);
+  fsu::g_parallel_quick_sort_3w(V.Begin(), V.End(), gt);
+  Display(V,'V',std::cout,ofc);
+  fsu::g_parallel_quick_sort_3w(Q.Begin(), Q.End(), gt);
+  Display(Q,'Q',std::cout,ofc);
+  // fsu::g_parallel_quick_sort_3w(L.Begin(), L.End(), gt);
+  // Display(L,'L',std::cout,ofc);
+  // */
+
+  // g_sort()
+  SortHeader("g_sort()");
+  Restore(L,V,Q,A,inputData);
+  fsu::g_sort(A, A + size);
+  Display(A,size,'A',std::cout,ofc);
+  fsu::g_sort(V.Begin(), V.End());
+  Display(V,'V',std::cout,ofc);
+  fsu::g_sort(Q.Begin(), Q.End());
+  Display(Q,'Q',std::cout,ofc);
+  // fsu::g_sort(L.Begin(), L.End());
+  // Display(L,'L',std::cout,ofc);
+  // */
+
+  // g_sort(>)
+  SortHeader("g_sort(>)");
+  Restore(L,V,Q,A,inputData);
+  fsu::g_sort(A, A + size, gt);
+  Display(A,size,'A',std::cout,ofc);
+  fsu::g_sort(V.Begin(), V.End(), gt);
+  Display(V,'V',std::cout,ofc);
+  fsu::g_sort(Q.Begin(), Q.End(), gt);
+  Display(Q,'Q',std::cout,ofc);
+  // fsu::g_sort(L.Begin(), L.End(), gt);
+  // Display(L,'L',std::cout,ofc);
+  // */
+
+  // g_sort_by_key()
+  SortHeader("g_sort_by_key()");
+  Restore(L,V,Q,A,inputData);
+  fsu::g_sort_by_key(A, A + size, Identity());
+  Display(A,size,'A',std::cout,ofc);
+  fsu::g_sort_by_key(V.Begin(), V.End(), Identity());
+  Display(V,'V',std::cout,ofc);
+  fsu::g_sort_by_key(Q.Begin(), Q.End(), Identity());
+  Display(Q,'Q',std::cout,ofc);
+  // */
+
+  // g_sort_by_key(>)
+  SortHeader("g_sort_by_key(>)");
+  Restore(L,V,Q,A,inputData);
+  fsu::g_sort_by_key(A, A + size, Identity(), gt);
+  Display(A,size,'A',std::cout,ofc);
+  fsu::g_sort_by_key(V.Begin(), V.End(), Identity(), gt);
+  Display(V,'V',std::cout,ofc);
+  fsu::g_sort_by_key(Q.Begin(), Q.End(), Identity(), gt);
+  Display(Q,'Q',std::cout,ofc);
+  // */
+
   delete [] A;
   std::cout << "\nEnd test of generic sort algorithms < " << e_t << " >\n";
 
@@ -0,0 +1,199 @@
+/*
+    fipq.cpp
+    10/19/26
+
+    functionality test of the indexed priority queue
+
+    ipq.h: IndexedPriorityQueue - Push, Pop, Top, TopHandle, Update,
+           IncreaseKey, DecreaseKey, Erase, Contains, [], Size, Clear
+
+    The queue is least first (GreaterThan), as for Dijkstra. Commands come
+    from the keyboard or, named on the command line, from a file.
+*/
+
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+
+#include <compare.h>
+#include <ipq.h>
+
+typedef int ElementType; const char* e_t = "int";
+typedef fsu::IndexedPriorityQueue < ElementType , fsu::GreaterThan<ElementType> , 4 > QueueType;
+
+void DisplayMenu ()
+{
+  std::cout << "     Push(x)  .................  + x\n"
+            << "     Pop()  ...................  -\n"
+            << "     Top(), TopHandle()  ......  t\n"
+            << "     Update(h,x)  .............  u h x\n"
+            << "     IncreaseKey(h,x)  ........  i h x\n"
+            << "     DecreaseKey(h,x)  ........  d h x\n"
+            << "     Erase(h)  ................  e h\n"
+            << "     Contains(h), [h]  ........  c h\n"
+            << "     Size()  ..................  s\n"
+            << "     Clear()  .................  C\n"
+            << "     Display()  ...............  D\n"
+            << "     Dump()  ..................  W\n"
+            << "     Display this menu  .......  m\n"
+            << "     Quit program  ............  q\n";
+}
+
+// Contains(h), or false with a message
+bool InUse (const QueueType& q, QueueType::Handle h)
+{
+  if (q.Contains(h))
+    return 1;
+  std::cout << " ** no entry has handle " << h << '\n'
+            << " ** try again\n";
+  return 0;
+}
+
+int main(int argc, char* argv[])
+{
+  bool BATCH = 0;
+  std::ifstream comstream;
+  std::istream* comstreamPtr(&std::cin);
+  if (argc == 2)
+  {
+    comstream.open(argv[1]);
+    if (comstream.fail())
+    {
+      std::cout << " ** Error: unable to open command file \"" << argv[1] << "\"\n";
+      return (EXIT_FAILURE);
+    }
+    comstreamPtr = &comstream;
+    BATCH = 1;
+  }
+  else if (argc > 2)
+  {
+    std::cout << " ** Error: too many command line arguments\n"
+              << "    for INTERACTIVE mode enter no arguments\n"
+              << "    for BATCH mode enter command file name\n";
+    return (EXIT_FAILURE);
+  }
+
+  std::istream& is = *comstreamPtr;
+  QueueType q;
+  QueueType::Handle h;
+  ElementType x;
+  char option;
+
+  std::cout << "Begin test of IndexedPriorityQueue < " << e_t << " , GreaterThan , 4 >\n";
+  if (!BATCH) DisplayMenu();
+  do
+  {
+    std::cout << "Enter [command][argument] ('m' for menu, 'q' to quit): ";
+    if (!(is >> option))
+      break;
+    if (BATCH) std::cout << option;
+    switch (option)
+    {
+      case '+':
+        is >> x;
+        if (BATCH) std::cout << ' ' << x << '\n';
+        h = q.Push(x);
+        std::cout << "  handle " << h << '\n';
+        break;
+
+      case '-':
+        if (BATCH) std::cout << '\n';
+        if (q.Empty())
+        {
+          std::cout << " ** queue is empty\n"
+                    << " ** try again\n";
+          break;
+        }
+        std::cout << "  popped " << q.Top() << " (handle " << q.TopHandle() << ")\n";
+        q.Pop();
+        break;
+
+      case 't':
+        if (BATCH) std::cout << '\n';
+        if (q.Empty())
+          std::cout << "  queue is empty\n";
+        else
+          std::cout << "  top " << q.Top() << " (handle " << q.TopHandle() << ")\n";
+        break;
+
+      case 'u': case 'i': case 'd':
+        is >> h >> x;
+        if (BATCH) std::cout << ' ' << h << ' ' << x << '\n';
+        if (!InUse(q, h))
+          break;
+        if (option == 'u')
+          q.Update(h, x);
+        else if (option == 'i' && x > q[h]) // least first: a larger x is not an increase
+          std::cout << " ** " << x << " comes after " << q[h] << " in the order\n"
+                    << " ** try again\n";
+        else if (option == 'i')
+          q.IncreaseKey(h, x);
+        else if (x < q[h])
+          std::cout << " ** " << x << " comes before " << q[h] << " in the order\n"
+                    << " ** try again\n";
+        else
+          q.DecreaseKey(h, x);
+        break;
+
+      case 'e':
+        is >> h;
+        if (BATCH) std::cout << ' ' << h << '\n';
+        if (!InUse(q, h))
+          break;
+        std::cout << "  erased " << q[h] << '\n';
+        q.Erase(h);
+        break;
+
+      case 'c':
+        is >> h;
+        if (BATCH) std::cout << ' ' << h << '\n';
+        if (q.Contains(h))
+          std::cout << "  handle " << h << ": " << q[h] << '\n';
+        else
+          std::cout << "  handle " << h << " not in use\n";
+        break;
+
+      case 's':
+        if (BATCH) std::cout << '\n';
+        std::cout << "  size " << q.Size() << '\n';
+        break;
+
+      case 'C':
+        if (BATCH) std::cout << '\n';
+        q.Clear();
+        break;
+
+      case 'D':
+        if (BATCH) std::cout << '\n';
+        std::cout << "  q: ";
+        q.Display(std::cout, ' ');
+        std::cout << '\n';
+        break;
+
+      case 'W':
+        if (BATCH) std::cout << '\n';
+        q.Dump(std::cout);
+        break;
+
+      case 'm':
+        if (BATCH) std::cout << '\n';
+        DisplayMenu();
+        break;
+
+      case 'q':
+        if (BATCH) std::cout << '\n';
+        break;
+
+      default:
+        if (BATCH) std::cout << '\n';
+        std::cout << " ** command not found\n"
+                  << " ** try again\n";
+        is.ignore(1000, '\n');
+    }
+    if (!q.Check())
+      std::cout << " ** heap or handle map inconsistent\n";
+  }
+  while (option != 'q');
+  std::cout << "\nEnd test of IndexedPriorityQueue\n";
+  return 0;
+}
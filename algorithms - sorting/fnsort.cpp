@@ -12,11 +12,13 @@
 #include <iomanip>
 #include <fstream>
 #include <cctype>
+#include <limits>
 
 #include <vector.h>
 #include <genalg.h>
 #include <gheap.h>
 #include <nsort.h>
+#include <rsort.h>
 #include <compare.h>
 #include <insert.h>
 
@@ -80,6 +82,12 @@ void SortHeader (const char* name)
   std::cout << "\n== " << name << " ==\n";
 }
 
+// integers are shown as numbers (the char types too), floating values as they are
+template <typename T>
+long Shown (T t) { return (long)t; }
+inline float  Shown (float t)  { return t; }
+inline double Shown (double t) { return t; }
+
 // these functions facilitate the output displays
 // first the version for container classes
 template <class C>
@@ -94,10 +102,10 @@ void Display
   os << std::setw(2) << name << ": ";
   if (ofc == '\0')
     for (typename C::Iterator i = c.Begin(); i != c.End(); ++i)
-      os << (long)*i;
+      os << Shown(*i);
   else
     for (typename C::Iterator i = c.Begin(); i != c.End(); ++i)
-      os << (long)*i << ofc;
+      os << Shown(*i) << ofc;
   os << '\n';
 }
 
@@ -115,13 +123,34 @@ void Display
   os << std::setw(2) << name << ": ";
   if (ofc == '\0')
     for (T* Aitr = A; Aitr != A + size; ++Aitr)
-      os << (long)*Aitr;
+      os << Shown(*Aitr);
   else
     for (T* Aitr = A; Aitr != A + size; ++Aitr)
-      os << (long)*Aitr << ofc;
+      os << Shown(*Aitr) << ofc;
   os << '\n';
 }
 
+// the floating point data: the input over 4, every third one negated, so
+// there are fractions of both signs, then the values with a place of their
+// own in the order: signed zeros, infinities and NaNs of both signs
+const size_t floatSpecials = 9;
+
+template <typename F , typename T>
+size_t FloatData (F* A, const fsu::Vector< T >& source)
+{
+  size_t n = source.Size();
+  for (size_t i = 0; i < n; ++i)
+  {
+    A[i] = (F)source[i] / 4;
+    if (i % 3 == 1) A[i] = -A[i];
+  }
+  const F inf = std::numeric_limits<F>::infinity(), nan = std::numeric_limits<F>::quiet_NaN();
+  const F specials [floatSpecials] = { (F)-0.0, (F)0.5, nan, (F)0.0, -inf, (F)-0.5, -nan, inf, (F)-0.0 };
+  for (size_t i = 0; i < floatSpecials; ++i)
+    A[n + i] = specials[i];
+  return n + floatSpecials;
+}
+
 // this function puts the input data back to the array A for another sort
 template <typename S , typename T>
 void Restore(S* A, const fsu::Vector< T >& source)
@@ -201,6 +230,11 @@ int main(int argc, char* argv[])
   SmallElementType  * A2 = new SmallElementType [size];
   LargeElementType  * A8 = new LargeElementType [size];
 
+  // these used in radix_sort only, with floatSpecials more:
+  float             * F4 = new float [size + floatSpecials];
+  double            * F8 = new double [size + floatSpecials];
+  size_t fsize;
+
 
   std::cout << "data as entered: ";
   Display(inputData,"I",std::cout,ofc);
@@ -351,6 +385,66 @@ int main(int argc, char* argv[])
   Display(A8, size, "A8", std::cout, ofc);
   // */
 
+  // radix_sort type char
+  SortHeader("radix_sort - type char");
+  Restore (A1,inputData);
+  std::cout << "array before call:\n";
+  Display(A1, size, "A1", std::cout, ofc);
+  fsu::radix_sort(A1,size);
+  std::cout << "array after call:\n";
+  Display(A1, size, "A1", std::cout, ofc);
+  // */
+
+  // radix_sort type short
+  SortHeader("radix_sort - type short");
+  Restore (A2,inputData);
+  std::cout << "array before call:\n";
+  Display(A2, size, "A2", std::cout, ofc);
+  fsu::radix_sort(A2,size);
+  std::cout << "array after call:\n";
+  Display(A2, size, "A2", std::cout, ofc);
+  // */
+
+  // radix_sort type int
+  SortHeader("radix_sort - type int");
+  Restore (A4,inputData);
+  std::cout << "array before call:\n";
+  Display(A4, size, "A4", std::cout, ofc);
+  fsu::radix_sort(A4,size);
+  std::cout << "array after call:\n";
+  Display(A4, size, "A4", std::cout, ofc);
+  // */
+
+  // radix_sort type long
+  SortHeader("radix_sort - type long");
+  Restore (A8,inputData);
+  std::cout << "array before call:\n";
+  Display(A8, size, "A8", std::cout, ofc);
+  fsu::radix_sort(A8,size);
+  std::cout << "array after call:\n";
+  Display(A8, size, "A8", std::cout, ofc);
+  // */
+
+  // radix_sort type float
+  SortHeader("radix_sort - type float");
+  fsize = FloatData (F4,inputData);
+  std::cout << "array before call:\n";
+  Display(F4, fsize, "F4", std::cout, ofc);
+  fsu::radix_sort(F4,fsize);
+  std::cout << "array after call:\n";
+  Display(F4, fsize, "F4", std::cout, ofc);
+  // */
+
+  // radix_sort type double
+  SortHeader("radix_sort - type double");
+  fsize = FloatData (F8,inputData);
+  std::cout << "array before call:\n";
+  Display(F8, fsize, "F8", std::cout, ofc);
+  fsu::radix_sort(F8,fsize);
+  std::cout << "array after call:\n";
+  Display(F8, fsize, "F8", std::cout, ofc);
+  // */
+
   // g_heap_sort(>)
   SortHeader("g_heap_sort(>)");
   Restore(A4,inputData);
@@ -373,6 +467,8 @@ int main(int argc, char* argv[])
   delete [] A4;
   delete [] A8;
   delete [] B4;
+  delete [] F4;
+  delete [] F8;
 
   std::cout << "\nEnd test of numeric sort algorithms < " << e_t << " >\n";
 
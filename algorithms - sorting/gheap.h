@@ -36,6 +36,40 @@
 
     g_build_heap has runtime ~2n [see Cormen pp. 158-9]
 
+    d-ary heaps: g_push_heap_dary<D>, g_pop_heap_dary<D>, g_heap_repair_dary<D>,
+    g_build_heap_dary<D> and g_heap_sort_dary<D> are the same algorithms
+    with D children per node, at D*i+1 .. D*i+D. The tree is log2(D) times
+    shallower, so a pop makes that many fewer steps down, each a likely
+    cache miss on a large heap, for D-1 comparisons per step instead of 1.
+    The D children of a node sit together; when beg + 1 is aligned to
+    D * sizeof(T) bytes, and that is at most a cache line, each group of
+    children is inside one line, and a step down touches one line.
+    g_heap_sort_dary arranges that itself, heap sorting all but the first
+    few (< D) elements of a pointer range and inserting those at the end.
+    Elements are moved along a hole rather than swapped. D = 4 or 8 is
+    usual; g_heap_sort_dary<2> is a binary heapsort by moves.
+
+    bottom-up heaps [Wegener]: g_heap_repair_bu, g_pop_heap_bu and
+    g_heap_sort_bu. g_heap_repair compares at each level the larger child
+    with the element being placed, 2 comparisons per level, although that
+    element, taken from the bottom of the heap for a pop, almost always
+    belongs near the bottom again. The bottom-up repair moves the hole all
+    the way down the path of larger children, 1 comparison per level, and
+    then the element up from the leaf, which is rarely more than a level or
+    two. A pop takes about log n comparisons instead of 2 log n; it pays
+    where comparisons are expensive, and for cheap ones on heaps too big for
+    the cache, but on small heaps of integers the longer descent can lose.
+
+    partial sort: g_partial_sort(beg, mid, end) leaves in [beg,mid), sorted,
+    the k = mid - beg elements a sort would put there, for O(n log k)
+    instead of O(n log n). A POT of the first k is built in place; each
+    later element that comes before its top replaces the top, which is
+    repaired; at the end the POT is popped into order. On random data only
+    about k ln(n/k) of the later elements make it in, so for k much less
+    than n the scan of [mid,end) costs little more than one comparison per
+    element. See also topk.h, the same heap kept for a stream, and
+    g_nth_element in gsort.h.
+
     Copyright 2014, R. C. Lacher
 */
 
@@ -43,6 +77,11 @@
 #define _GHEAP_H
 
 #include <cstdlib>   // size_t
+#include <cstdint>   // uintptr_t
+#include <utility>   // std::move, std::declval
+#include <type_traits>
+#include <compare.h> // LessThan, for the default order d-ary versions
+#include <ginstrument.h>
 
 namespace fsu
 {
@@ -117,6 +156,54 @@ namespace fsu
   void g_heap_repair(I beg, I loc, I end);
   // the default order version
 
+  template <size_t D, class I, class P>
+  void g_push_heap_dary (I beg, I end, P& pred);
+  template <size_t D, class I>
+  void g_push_heap_dary (I beg, I end);
+
+  template <size_t D, class I, class P>
+  void g_pop_heap_dary (I beg, I end, P& pred);
+  template <size_t D, class I>
+  void g_pop_heap_dary (I beg, I end);
+
+  template <size_t D, class I, class P>
+  void g_heap_repair_dary (I beg, I loc, I end, P& pred);
+  template <size_t D, class I>
+  void g_heap_repair_dary (I beg, I loc, I end);
+
+  template <size_t D, class I, class P>
+  void g_build_heap_dary (I beg, I end, P& pred);
+  template <size_t D, class I>
+  void g_build_heap_dary (I beg, I end);
+
+  template <size_t D, class I, class P>
+  void g_heap_sort_dary (I beg, I end, P& pred);
+  template <size_t D, class I>
+  void g_heap_sort_dary (I beg, I end);
+  // as the binary versions above, with D children per node
+
+  template <class I, class P>
+  void g_heap_repair_bu (I beg, I loc, I end, P& pred);
+  template <class I>
+  void g_heap_repair_bu (I beg, I loc, I end);
+
+  template <class I, class P>
+  void g_pop_heap_bu (I beg, I end, P& pred);
+  template <class I>
+  void g_pop_heap_bu (I beg, I end);
+
+  template <class I, class P>
+  void g_heap_sort_bu (I beg, I end, P& pred);
+  template <class I>
+  void g_heap_sort_bu (I beg, I end);
+  // bottom-up: as g_heap_repair, g_pop_heap and g_heap_sort, with fewer comparisons
+
+  template <class I, class P>
+  void g_partial_sort (I beg, I mid, I end, P& pred);
+  template <class I>
+  void g_partial_sort (I beg, I mid, I end);
+  // the first mid - beg of the order, sorted, in [beg,mid), with a heap of that many
+
   template <typename T>
   void g_XC (T& t1, T& t2);
 
@@ -167,7 +254,7 @@ namespace fsu
       // test order property at i; if bad, swap and repeat
       if (largest != i)
       {
-        ::fsu::g_XC(beg[i],beg[largest]);
+        instrument::XC(beg[i],beg[largest],p);
         i = largest;
       }
       else finished = 1;
@@ -334,7 +421,7 @@ namespace fsu
         p = (i - 1) >> 1;
         if (pred(beg[p],beg[i]))
         {
-          g_XC(beg[i], beg[p]);
+          instrument::XC(beg[i], beg[p], pred);
           i = p;
         }
         else
@@ -396,7 +483,7 @@ namespace fsu
   {
     if (end - beg < 2)
       return;
-    g_XC(*beg,*(end - 1));
+    instrument::XC(*beg,*(end - 1),pred);
     g_heap_repair(beg,beg,end - 1,pred);
   } // end g_pop_heap()
 
@@ -412,12 +499,347 @@ namespace fsu
 
   template <typename T>
   void g_XC (T& t1, T& t2)
+  // moves where T can be moved, copies otherwise
+  {
+    T temp(std::move(t1));
+    t1 = std::move(t2);
+    t2 = std::move(temp);
+  }
+
+  //---------------------------------
+  // d-ary heaps
+  //---------------------------------
+
+  namespace dary
+  {
+
+    template <class I>
+    struct Value
+    {
+      typedef typename std::remove_reference<decltype(*std::declval<I>())>::type Type;
+    };
+
+    template <class I, class P>
+    size_t Largest (I beg, size_t c, size_t n, P& pred)
+    // the position of the largest of [c,n)
+    {
+      size_t largest = c;
+      for (size_t j = c + 1; j < n; ++j)
+        largest = pred(beg[largest], beg[j]) ? j : largest;
+      return largest;
+    }
+
+    template <size_t D, class I, class P>
+    size_t LargestChild (I beg, size_t c, P& pred)
+    // the largest of the D children from c of a node
+    {
+      size_t largest = c;
+      for (size_t j = c + 1; j < c + D; ++j) // D is a constant: unrolled
+        largest = pred(beg[largest], beg[j]) ? j : largest;
+      return largest;
+    }
+
+    // elements to leave out in front so that the child groups of a heap
+    // after them are aligned; 0 where no alignment is possible
+    template <size_t D, typename T>
+    size_t AlignOffset (T* beg)
+    {
+      const size_t group = D * sizeof(T);
+      if (group > 64 || (group & (group - 1)) != 0)
+        return 0;
+      uintptr_t first = (uintptr_t)(beg + 1); // the root's children
+      if (first % sizeof(T) != 0)
+        return 0;
+      return ((group - first % group) % group) / sizeof(T);
+    }
+
+    template <size_t D, class I>
+    size_t AlignOffset (I)
+    {
+      return 0;
+    }
+
+    template <class I, class P>
+    void InsertFront (I beg, I end, P& pred)
+    // Pre:  [beg+1,end) is sorted by pred
+    // Post: [beg,end) is sorted by pred
+    {
+      typename Value<I>::Type t(std::move(*beg));
+      I lo = beg + 1, hi = end; // first position whose element goes after t
+      while (lo < hi)
+      {
+        I mid = lo + ((hi - lo) >> 1);
+        if (pred(t, *mid)) hi = mid;
+        else               lo = mid + 1;
+      }
+      I i = beg;
+      for ( ; i + 1 != lo; ++i)
+        *i = std::move(*(i + 1));
+      *i = std::move(t);
+      instrument::Move(pred, 2 + (lo - beg - 1));
+    }
+
+  } // namespace dary
+
+  template <size_t D, class I, class P>
+  void g_heap_repair_dary (I beg, I loc, I end, P& pred)
+  // Pre:  the subtrees of the children of loc are POT
+  // Post: loc is POT
+  {
+    static_assert(D >= 2, "a heap needs at least 2 children per node");
+    size_t n = end - beg;
+    size_t i = loc - beg;
+    if (i >= n)
+      return;
+    typename dary::Value<I>::Type t(std::move(beg[i]));
+    size_t moves = 2;
+    size_t c = D * i + 1;
+    for ( ; c + D <= n; c = D * i + 1) // a full group of children
+    {
+      size_t m = dary::LargestChild<D>(beg, c, pred);
+      if (!pred(t, beg[m]))
+      {
+        c = n;
+        break;
+      }
+      beg[i] = std::move(beg[m]);
+      ++moves;
+      i = m;
+    }
+    if (c < n) // the last parent's group, short
+    {
+      size_t m = dary::Largest(beg, c, n, pred);
+      if (pred(t, beg[m]))
+      {
+        beg[i] = std::move(beg[m]);
+        ++moves;
+        i = m;
+      }
+    }
+    beg[i] = std::move(t);
+    instrument::Move(pred, moves);
+  }
+
+  template <size_t D, class I>
+  void g_heap_repair_dary (I beg, I loc, I end)
+  {
+    fsu::LessThan < typename dary::Value<I>::Type > lt;
+    g_heap_repair_dary<D>(beg, loc, end, lt);
+  }
+
+  template <size_t D, class I, class P>
+  void g_push_heap_dary (I beg, I end, P& pred)
+  // Pre:  [beg,end-1) is a POT
+  // Post: [beg,end) is a POT
+  {
+    static_assert(D >= 2, "a heap needs at least 2 children per node");
+    size_t i = end - beg;
+    if (i < 2)
+      return;
+    --i;
+    typename dary::Value<I>::Type t(std::move(beg[i]));
+    size_t moves = 2;
+    while (i > 0)
+    {
+      size_t p = (i - 1) / D;
+      if (!pred(beg[p], t))
+        break;
+      beg[i] = std::move(beg[p]);
+      ++moves;
+      i = p;
+    }
+    beg[i] = std::move(t);
+    instrument::Move(pred, moves);
+  }
+
+  template <size_t D, class I>
+  void g_push_heap_dary (I beg, I end)
+  {
+    fsu::LessThan < typename dary::Value<I>::Type > lt;
+    g_push_heap_dary<D>(beg, end, lt);
+  }
+
+  template <size_t D, class I, class P>
+  void g_pop_heap_dary (I beg, I end, P& pred)
+  // Pre:  [beg,end) is a non-empty POT
+  // Post: its largest element is at end - 1, and [beg,end-1) is a POT
+  {
+    if (end - beg < 2)
+      return;
+    instrument::XC(*beg, *(end - 1), pred);
+    g_heap_repair_dary<D>(beg, beg, end - 1, pred);
+  }
+
+  template <size_t D, class I>
+  void g_pop_heap_dary (I beg, I end)
+  {
+    fsu::LessThan < typename dary::Value<I>::Type > lt;
+    g_pop_heap_dary<D>(beg, end, lt);
+  }
+
+  template <size_t D, class I, class P>
+  void g_build_heap_dary (I beg, I end, P& pred)
+  // Post: [beg,end) is a POT
+  {
+    size_t size = end - beg;
+    if (size < 2)
+      return;
+    for (size_t i = (size - 2) / D + 1; i > 0; --i) // the last parent first
+      g_heap_repair_dary<D>(beg, beg + (i - 1), end, pred);
+  }
+
+  template <size_t D, class I>
+  void g_build_heap_dary (I beg, I end)
   {
-    T temp(t1);
-    t1 = t2;
-    t2 = temp;
+    fsu::LessThan < typename dary::Value<I>::Type > lt;
+    g_build_heap_dary<D>(beg, end, lt);
   }
-  
+
+  template <size_t D, class I, class P>
+  void g_heap_sort_dary (I beg, I end, P& pred)
+  // as g_heap_sort
+  {
+    if (end - beg <= 1)
+      return;
+    size_t skip = dary::AlignOffset<D>(beg);
+    if ((size_t)(end - beg) < 2 * D)
+      skip = 0;
+    I b = beg + skip;
+    g_build_heap_dary<D>(b, end, pred);
+    for (size_t i = end - b; i > 1; --i)
+      g_pop_heap_dary<D>(b, b + i, pred);
+    for (size_t k = skip; k > 0; --k)
+      dary::InsertFront(beg + (k - 1), end, pred);
+  }
+
+  template <size_t D, class I>
+  void g_heap_sort_dary (I beg, I end)
+  {
+    fsu::LessThan < typename dary::Value<I>::Type > lt;
+    g_heap_sort_dary<D>(beg, end, lt);
+  }
+
+  //---------------------------------
+  // bottom-up heaps
+  //---------------------------------
+
+  template <class I, class P>
+  void g_heap_repair_bu (I beg, I loc, I end, P& pred)
+  // Pre:  both left and right subtrees of loc are POT
+  // Post: loc is POT
+  {
+    size_t n = end - beg;
+    size_t top = loc - beg;
+    if (top >= n)
+      return;
+    typename dary::Value<I>::Type t(std::move(beg[top]));
+    size_t i = top, l, moves = 2;
+    // the hole down to a leaf, along the larger children
+    for (l = (i << 1) | 0x01; l + 1 < n; l = (i << 1) | 0x01)
+    {
+      if (pred(beg[l], beg[l + 1]))
+        ++l;
+      beg[i] = std::move(beg[l]);
+      ++moves;
+      i = l;
+    }
+    if (l < n) // an only child
+    {
+      beg[i] = std::move(beg[l]);
+      ++moves;
+      i = l;
+    }
+    // t up from the leaf to where it belongs
+    while (i > top)
+    {
+      size_t p = (i - 1) >> 1;
+      if (!pred(beg[p], t))
+        break;
+      beg[i] = std::move(beg[p]);
+      ++moves;
+      i = p;
+    }
+    beg[i] = std::move(t);
+    instrument::Move(pred, moves);
+  }
+
+  template <class I>
+  void g_heap_repair_bu (I beg, I loc, I end)
+  {
+    fsu::LessThan < typename dary::Value<I>::Type > lt;
+    g_heap_repair_bu(beg, loc, end, lt);
+  }
+
+  template <class I, class P>
+  void g_pop_heap_bu (I beg, I end, P& pred)
+  // as g_pop_heap
+  {
+    if (end - beg < 2)
+      return;
+    instrument::XC(*beg, *(end - 1), pred);
+    g_heap_repair_bu(beg, beg, end - 1, pred);
+  }
+
+  template <class I>
+  void g_pop_heap_bu (I beg, I end)
+  {
+    fsu::LessThan < typename dary::Value<I>::Type > lt;
+    g_pop_heap_bu(beg, end, lt);
+  }
+
+  template <class I, class P>
+  void g_heap_sort_bu (I beg, I end, P& pred)
+  // as g_heap_sort; the heap is built bottom-up as well
+  {
+    if (end - beg <= 1)
+      return;
+    size_t size = end - beg;
+    for (size_t i = size/2; i > 0; --i)
+      g_heap_repair_bu(beg, beg + (i - 1), end, pred);
+    for (size_t i = size; i > 1; --i)
+      g_pop_heap_bu(beg, beg + i, pred);
+  }
+
+  template <class I>
+  void g_heap_sort_bu (I beg, I end)
+  {
+    fsu::LessThan < typename dary::Value<I>::Type > lt;
+    g_heap_sort_bu(beg, end, lt);
+  }
+
+  //---------------------------------
+  // partial sort
+  //---------------------------------
+
+  template <class I, class P>
+  void g_partial_sort (I beg, I mid, I end, P& pred)
+  // Pre:  [beg,mid) and [mid,end) are valid ranges
+  // Post: [beg,mid) holds the mid - beg elements that come first in the
+  //       order pred, sorted; [mid,end) holds the rest, in no order
+  // Runtime: O(n log k), k = mid - beg; space: O(1)
+  {
+    if (mid - beg < 1)
+      return;
+    g_build_heap(beg, mid, pred);
+    for (I i = mid; i != end; ++i)
+    {
+      if (pred(*i, *beg)) // *i belongs among the first k: it replaces the largest of them
+      {
+        instrument::XC(*i, *beg, pred);
+        g_heap_repair(beg, beg, mid, pred);
+      }
+    }
+    for (size_t k = mid - beg; k > 1; --k)
+      g_pop_heap(beg, beg + k, pred);
+  }
+
+  template <class I>
+  void g_partial_sort (I beg, I mid, I end)
+  {
+    fsu::LessThan < typename dary::Value<I>::Type > lt;
+    g_partial_sort(beg, mid, end, lt);
+  }
+
 } // namespace fsu
 
 namespace alt
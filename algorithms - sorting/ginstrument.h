@@ -0,0 +1,312 @@
+/*
+    ginstrument.h
+    10/19/26
+
+    instrumentation of the generic sorts as a compile-time policy
+
+      fsu::Instrumented < fsu::LessThan<T> > cmp;  // counts, else the same as LessThan
+      fsu::CountInstrument::Reset();
+      fsu::g_intro_sort(a, a + n, cmp);            // timed as usual
+      fsu::SortCounters c = fsu::CountInstrument::Total();
+
+    The policy travels with the predicate type, so no sort changes its
+    signature. A sort reports what it does through the helpers of namespace
+    instrument (Move, Swap, XC, Partition and the Level guard), each taking
+    the predicate only for its type. For any predicate but Instrumented the
+    policy is NoInstrument, whose members are empty: the hooks compile to
+    nothing and the sorts are the same code as before.
+
+    CountInstrument records comparisons (in Instrumented::operator()),
+    element moves, swaps, the deepest recursion level and, for each
+    partition, the share of the smaller side in 5% bins. The counters are
+    thread local, so the parallel sorts count without contention; Total adds
+    up every thread's (the deepest level is the deepest of any one thread,
+    whose count starts over in each task a worker runs). Total and Reset are
+    for when no sort is running. A thread's counters join the total at its
+    first count of any kind (Reset joins the calling thread), so no count
+    is made where Reset cannot clear it; after that, a count costs the
+    thread's check that it has joined and an increment.
+
+    Counting is not free: on 10^6 random uint32 here it costs the quicksorts
+    and g_intro_sort 15-35% of their time, g_merge_sort_opt 12-20% and
+    g_heap_sort 12-45%, where the counted moves undo the branch-free child
+    selection. Time a sort with the plain predicate and count it in another
+    run, as sortspy does.
+
+    A move is one element assigned to a new place (into a buffer and back is
+    two); a swap (g_XC) is counted as a swap, not as its three moves. The
+    counts are exact for the sorts of gsort.h, gsort_par.h and gheap.h;
+    snet::LeafSort counts its network's compare-exchanges as comparisons.
+*/
+
+#ifndef _GINSTRUMENT_H
+#define _GINSTRUMENT_H
+
+#include <cstdlib>   // size_t
+#include <mutex>
+#include <vector>
+#include <algorithm> // std::find
+
+namespace fsu
+{
+
+  // gheap.h
+  template <typename T>
+  void g_XC (T& t1, T& t2);
+
+  const size_t balance_bins = 10; // of 5%: [0,5%) .. [45%,50%]
+
+  struct SortCounters
+  {
+    unsigned long long comparisons, moves, swaps, partitions;
+    size_t             maxDepth;
+    unsigned long long balance [balance_bins]; // partitions by the smaller side's share
+
+    // constant, so a thread_local one needs no initialization check
+    constexpr SortCounters ()
+      : comparisons(0), moves(0), swaps(0), partitions(0), maxDepth(0), balance() {}
+
+    void Reset ()
+    {
+      comparisons = moves = swaps = partitions = 0;
+      maxDepth = 0;
+      for (size_t i = 0; i < balance_bins; ++i) balance[i] = 0;
+    }
+
+    SortCounters& operator += (const SortCounters& c)
+    {
+      comparisons += c.comparisons;
+      moves       += c.moves;
+      swaps       += c.swaps;
+      partitions  += c.partitions;
+      if (maxDepth < c.maxDepth) maxDepth = c.maxDepth;
+      for (size_t i = 0; i < balance_bins; ++i) balance[i] += c.balance[i];
+      return *this;
+    }
+  };
+
+  // the bin of a partition into left and right (pivots and equal keys aside)
+  inline size_t BalanceBin (size_t left, size_t right)
+  {
+    size_t total = left + right;
+    if (total == 0) return balance_bins - 1;
+    size_t smaller = (left < right) ? left : right;
+    size_t bin = (size_t)((double)smaller / total * 2 * balance_bins);
+    return (bin < balance_bins) ? bin : balance_bins - 1;
+  }
+
+  struct NoInstrument
+  {
+    static void Compare   (size_t = 1) {}
+    static void Move      (size_t = 1) {}
+    static void Swap      (size_t = 1) {}
+    static void Enter     () {}
+    static void Leave     () {}
+    static void Partition (size_t, size_t) {}
+  };
+
+  class CountInstrument
+  {
+  public:
+    static void Compare (size_t k = 1)
+    {
+      Attach();
+      This().counters.comparisons += k;
+    }
+
+    static void Swap (size_t k = 1)
+    {
+      Attach();
+      This().counters.swaps += k;
+    }
+
+    static void Move (size_t k = 1)
+    {
+      Attach();
+      This().counters.moves += k;
+    }
+
+    static void Enter ()
+    {
+      Attach();
+      Local& l = This();
+      if (++l.depth > l.counters.maxDepth)
+        l.counters.maxDepth = l.depth;
+    }
+
+    static void Leave () { --This().depth; }
+
+    static void Partition (size_t left, size_t right)
+    {
+      Attach();
+      SortCounters& c = This().counters;
+      ++c.partitions;
+      ++c.balance[BalanceBin(left, right)];
+    }
+
+    // the counts of every thread since the last Reset
+    static SortCounters Total ()
+    {
+      Registry& r = Shared();
+      std::lock_guard < std::mutex > lock(r.mutex);
+      SortCounters t = r.retired;
+      for (size_t i = 0; i < r.locals.size(); ++i)
+        t += r.locals[i]->counters;
+      return t;
+    }
+
+    static void Reset ()
+    {
+      Attach();
+      Registry& r = Shared();
+      std::lock_guard < std::mutex > lock(r.mutex);
+      r.retired.Reset();
+      for (size_t i = 0; i < r.locals.size(); ++i)
+        r.locals[i]->counters.Reset();
+    }
+
+  private:
+    struct Local
+    {
+      SortCounters counters;
+      size_t       depth;
+
+      constexpr Local () : counters(), depth(0) {}
+    };
+
+    // puts the thread's counters in the registry for as long as it lives
+    struct Attachment
+    {
+      Attachment ()
+      {
+        Registry& r = Shared();
+        std::lock_guard < std::mutex > lock(r.mutex);
+        r.locals.push_back(&This());
+      }
+
+      ~Attachment () // a thread that ends leaves its counts behind
+      {
+        Registry& r = Shared();
+        std::lock_guard < std::mutex > lock(r.mutex);
+        r.retired += This().counters;
+        r.locals.erase(std::find(r.locals.begin(), r.locals.end(), &This()));
+      }
+    };
+
+    struct Registry
+    {
+      std::mutex           mutex;
+      std::vector<Local*>  locals;
+      SortCounters         retired;
+    };
+
+    // never destroyed: the workers of a static TaskPool may end after it would be
+    static Registry& Shared ()
+    {
+      static Registry* r = new Registry;
+      return *r;
+    }
+
+    static Local& This ()
+    {
+      static thread_local Local l;
+      return l;
+    }
+
+    static void Attach ()
+    {
+      static thread_local Attachment a;
+      (void)a;
+    }
+  };
+
+  // a predicate P that counts its calls through the policy I
+  template < class P , class I = CountInstrument >
+  class Instrumented
+  {
+  public:
+    Instrumented () : p_() {}
+    explicit Instrumented (const P& p) : p_(p) {}
+
+    template < typename T , typename U >
+    bool operator () (const T& a, const U& b) const
+    {
+      I::Compare();
+      return p_(a, b);
+    }
+
+    P& Predicate () const { return p_; }
+
+  private:
+    mutable P p_;
+  };
+
+  // the policy of a predicate type
+  template < class P >
+  struct InstrumentOf
+  {
+    typedef NoInstrument Type;
+  };
+
+  template < class P , class I >
+  struct InstrumentOf < Instrumented<P,I> >
+  {
+    typedef I Type;
+  };
+
+  template < class P , class I >
+  struct InstrumentOf < const Instrumented<P,I> >
+  {
+    typedef I Type;
+  };
+
+  namespace instrument
+  {
+
+    // the hooks: cmp is the sort's predicate, used for its type only
+
+    template < class P >
+    inline void Move (const P&, size_t k = 1)
+    {
+      InstrumentOf<P>::Type::Move(k);
+    }
+
+    template < class P >
+    inline void Swap (const P&, size_t k = 1)
+    {
+      InstrumentOf<P>::Type::Swap(k);
+    }
+
+    // g_XC, counted
+    template < typename T , class P >
+    inline void XC (T& t1, T& t2, const P& cmp)
+    {
+      Swap(cmp);
+      g_XC(t1, t2);
+    }
+
+    template < class P >
+    inline void Partition (const P&, size_t left, size_t right)
+    {
+      InstrumentOf<P>::Type::Partition(left, right);
+    }
+
+    // one level of recursion, for the lifetime of the object:
+    //   instrument::Level < Comparator > level;
+    template < class P >
+    class Level
+    {
+    public:
+      Level ()  { InstrumentOf<P>::Type::Enter(); }
+      ~Level () { InstrumentOf<P>::Type::Leave(); }
+
+    private:
+      Level (const Level&);             // disallowed
+      Level& operator = (const Level&); // disallowed
+    };
+
+  } // namespace instrument
+
+} // namespace fsu
+
+#endif
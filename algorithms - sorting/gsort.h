@@ -11,10 +11,14 @@
 
       g_selection_sort
       g_merge_sort
+      g_merge_sort_adaptive
       g_insertion_sort
       g_quick_sort
+      g_intro_sort
+      g_nth_element
  
     note that g_heap_sort (all versions) are located in gheap_*.h
+    (g_intro_sort falls back on the g_heap_sort in gheap.h)
 
     stub version
       - has missing code in a number of places
@@ -23,10 +27,19 @@
     Copyright 2015, R. C. Lacher
 */
 
-#include <genalg.h> // Swap, g_copy
-#include <gset.h>   // g_set_merge
+#ifndef _GSORT_H
+#define _GSORT_H
 
-int cutoff = 0;
+#include <cstdlib>   // size_t
+#include <cstddef>   // ptrdiff_t
+#include <type_traits>
+#include <utility>   // std::move
+#include <genalg.h>  // Swap, g_copy
+#include <gheap.h>   // g_heap_sort, g_XC
+#include <compare.h> // LessThan
+#include <snet.h>    // sorting networks for short ranges
+#include <gsort_policy.h>
+#include <ginstrument.h> // counts, for an Instrumented predicate
 
 namespace fsu
 {
@@ -41,7 +54,7 @@ namespace fsu
       for (j = i; j != end; ++j)
         if (*j < *k)
           k = j;
-      Swap (*i, *k);
+      g_XC (*i, *k);
     }
   }
 
@@ -55,7 +68,7 @@ namespace fsu
       for (j = i; j != end; ++j)
         if (cmp(*j, *k))
           k = j;
-      Swap (*i, *k);
+      instrument::XC (*i, *k, cmp);
     }
   }
 
@@ -63,13 +76,12 @@ namespace fsu
   void g_insertion_sort (BidirectionalIterator beg, BidirectionalIterator end)
   {
     BidirectionalIterator i, j, k;
-    typename BidirectionalIterator::ValueType t;
     for (i = beg; i != end; ++i)
     {
-      t = *i;
+      typename BidirectionalIterator::ValueType t(std::move(*i));
       for (k = i, j = k--; j != beg && t < *k; --j, --k)
-        *j = *k;
-      *j = t;
+        *j = std::move(*k);
+      *j = std::move(t);
     }
   }
 
@@ -77,13 +89,14 @@ namespace fsu
   void g_insertion_sort (BidirectionalIterator beg, BidirectionalIterator end, Comparator& cmp)
   {
     BidirectionalIterator i, j, k;
-    typename BidirectionalIterator::ValueType t;
     for (i = beg; i != end; ++i)
     {
-      t = *i;
-      for (k = i, j = k--; j != beg && cmp(t,*k); --j, --k)
-        *j = *k;
-      *j = t;
+      typename BidirectionalIterator::ValueType t(std::move(*i));
+      size_t shifts = 0;
+      for (k = i, j = k--; j != beg && cmp(t,*k); --j, --k, ++shifts)
+        *j = std::move(*k);
+      *j = std::move(t);
+      instrument::Move(cmp, 2 + shifts);
     }
   }
 
@@ -93,13 +106,12 @@ namespace fsu
   {
     // fsu::Debug ("g_insertion_sort");
     T *i, *j, *k;
-    T t;
     for (i = beg; i != end; ++i)
     {
-      t = *i;
+      T t(std::move(*i));
       for (k = i, j = k--; j != beg && t < *k; --j, --k)
-        *j = *k;
-      *j = t;
+        *j = std::move(*k);
+      *j = std::move(t);
     }
   }
 
@@ -108,183 +120,632 @@ namespace fsu
   void g_insertion_sort (T* beg, T* end, Comparator& cmp)
   {
     T *i, *j, *k;
-    T t;
     for (i = beg; i != end; ++i)
     {
-      t = *i;
+      T t(std::move(*i));
       for (k = i, j = k--; j != beg && cmp(t,*k); --j, --k)
-        *j = *k;
-      *j = t;
+        *j = std::move(*k);
+      *j = std::move(t);
+      instrument::Move(cmp, 2 + (i - j));
     }
   }
 
+  // ValueTypeOf<I>::Type is the element type of a range, for fsu iterator
+  // classes (I::ValueType) and for ordinary pointers alike
+
+  template < class I >
+  struct ValueTypeOf
+  {
+    typedef typename I::ValueType Type;
+  };
+
+  template < typename T >
+  struct ValueTypeOf < T* >
+  {
+    typedef T Type;
+  };
+
+  // MergeBuffer<T>: scratch space for the merge sorts
+  //   MergeBuffer<T> b;          // empty; the sort allocates what it needs once
+  //   MergeBuffer<T> b(n);       // owns n elements, reusable across many sorts
+  //   MergeBuffer<T> b(space,n); // caller's own buffer or arena; never freed here
+  // A buffer that is too small is replaced by an owned one of the needed size.
+  // Owned space comes from the allocator A (see gsort_policy.h).
+
+  template < typename T , class A = NewAllocator >
+  class MergeBuffer
+  {
+  public:
+    MergeBuffer () : data_(0), size_(0), owner_(0) {}
+    explicit MergeBuffer (size_t n) : data_(A::template Allocate<T>(n)), size_(n), owner_(1) {}
+    MergeBuffer (T* space, size_t n) : data_(space), size_(n), owner_(0) {}
+    ~MergeBuffer () { Release(); }
+
+    void Reserve (size_t n)
+    {
+      if (n <= size_) return;
+      Release();
+      data_  = A::template Allocate<T>(n);
+      size_  = n;
+      owner_ = 1;
+    }
+
+    T*     Data () const { return data_; }
+    size_t Size () const { return size_; }
+
+  private:
+    void Release ()
+    {
+      if (owner_) A::Deallocate(data_);
+      data_ = 0; size_ = 0; owner_ = 0;
+    }
+
+    MergeBuffer (const MergeBuffer&);            // disallowed
+    MergeBuffer& operator = (const MergeBuffer&); // disallowed
+
+    T*     data_;
+    size_t size_;
+    bool   owner_;
+  };
+
   namespace mergesort
-  // note: These are supplied complete and ready for use
   {
 
-    // these are the special "merge" functions supporting merge sort
-    // note that these are complete and can be used as is
+    // Elements are moved, never copied: from the range to the buffer and
+    // back, and through every merge. Types without move operations are
+    // copied instead, as before.
 
-    // for random access iterators and default order
-    template < typename RAIterator >
-    void Merge(RAIterator beg, RAIterator mid, RAIterator end)
+    // moves [beg,end) to dest; returns the end of the destination
+    template < class I , class J >
+    J Move (I beg, I end, J dest)
     {
-      typename RAIterator::ValueType  B [end - beg];   // temp space for merged copy of A
-      g_set_merge(beg, mid, mid, end, B);      // merge the two parts of A to B
-      g_copy(B, B+(end-beg), beg);             // copy B back to A[p,r)
+      for ( ; beg != end; ++beg, ++dest)
+        *dest = std::move(*beg);
+      return dest;
     }
 
-    // for random access iterators and order determined by a predicate object
-    template < typename RAIterator , class Comparator >
-    void Merge(RAIterator beg, RAIterator mid, RAIterator end, Comparator& cmp)
+    // stable merge of sorted [a,ae) and [b,be) into dest (g_set_merge, by move)
+    template < class I , class J , class P >
+    J Merge (I a, I ae, I b, I be, J dest, P& cmp)
     {
-      typename RAIterator::ValueType  B [end - beg];
-      g_set_merge(beg, mid, mid, end, B, cmp);
-      g_copy(B, B+(end-beg), beg);
+      instrument::Move(cmp, (ae - a) + (be - b));
+      for ( ; a != ae && b != be; ++dest)
+      {
+        if (cmp(*b, *a)) { *dest = std::move(*b); ++b; }
+        else             { *dest = std::move(*a); ++a; }
+      }
+      return Move(b, be, Move(a, ae, dest));
     }
 
-    // specialization for pointers and default order
-    template < typename T >
-    void Merge(T* beg, T* mid, T* end)
+    // The top-down sorts alternate ("ping-pong") the roles of range and
+    // buffer from one level to the next, so each merge moves its elements
+    // straight into their destination and nothing is moved back.
+
+    // top-down
+    // Pre:  a[0,n) holds the elements
+    // Post: they are in order in b[0,n) if into, in a[0,n) otherwise; the
+    //       other side has been used as scratch
+    template < class I , class J , class P >
+    void Sort (I a, J b, size_t n, bool into, P& cmp)
+    {
+      if (n < 2)
+      {
+        if (into && n == 1)
+        {
+          *b = std::move(*a);
+          instrument::Move(cmp);
+        }
+        return;
+      }
+      instrument::Level < P > level;
+      size_t h = n >> 1;
+      Sort(a, b, h, !into, cmp);          // halves sorted into the other side
+      Sort(a + h, b + h, n - h, !into, cmp);
+      if (into)
+        Merge(a, a + h, a + h, a + n, b, cmp);
+      else
+        Merge(b, b + h, b + h, b + n, a, cmp);
+    }
+
+    // top-down with cutoff: runs of length <= cutoff are finished in place by
+    // snet::LeafSort, and already ordered halves are moved rather than merged
+    template < class I , class J , class P >
+    void SortOpt (I a, J b, size_t n, bool into, size_t cutoff, P& cmp)
     {
-      T B [end - beg];                     // temp space for merged copy of A
-      g_set_merge(beg, mid, mid, end, B);  // merge the two parts of A to B
-      g_copy(B, B+(end-beg), beg);         // copy B back to A[p,r)
+      if (n <= cutoff || n < 2)
+      {
+        snet::LeafSort(a, a + n, cmp);
+        if (into)
+        {
+          Move(a, a + n, b);
+          instrument::Move(cmp, n);
+        }
+        return;
+      }
+      instrument::Level < P > level;
+      size_t h = n >> 1;
+      SortOpt(a, b, h, !into, cutoff, cmp);
+      SortOpt(a + h, b + h, n - h, !into, cutoff, cmp);
+      if (into)
+      {
+        if (cmp(a[h], a[h - 1]))
+          Merge(a, a + h, a + h, a + n, b, cmp);
+        else
+        {
+          Move(a, a + n, b);
+          instrument::Move(cmp, n);
+        }
+      }
+      else
+      {
+        if (cmp(b[h], b[h - 1]))
+          Merge(b, b + h, b + h, b + n, a, cmp);
+        else
+        {
+          Move(b, b + n, a);
+          instrument::Move(cmp, n);
+        }
+      }
     }
 
-    // specialization for pointers and predicate order
-    template < typename T , class Comparator >
-    void Merge(T* beg, T* mid, T* end, Comparator& cmp)
+    // bottom-up: merges adjacent runs of width w in a[0,n) into b[0,n)
+    template < class I , class J , class P >
+    void MergePass (I a, J b, size_t n, size_t w, P& cmp)
     {
-      T B [end - beg];
-      g_set_merge(beg, mid, mid, end, B, cmp);
-      g_copy(B, B+(end-beg), beg);
+      size_t j = 0;
+      for ( ; j + w < n; j += w + w)
+      {
+        size_t e = (n - j > w + w) ? j + w + w : n;
+        Merge(a + j, a + (j + w), a + (j + w), a + e, b + j, cmp);
+      }
+      if (j < n) // odd run out is carried across unchanged
+      {
+        Move(a + j, a + n, b + j);
+        instrument::Move(cmp, n - j);
+      }
     }
 
   } // namespace mergesort
 
+  template < class RAIterator , class T , class A , class Comparator >
+  void g_merge_sort (RAIterator beg, RAIterator end, MergeBuffer<T,A>& buffer, Comparator& cmp)
+  {
+    size_t size = end - beg;
+    if (size < 2) return;
+    buffer.Reserve(size);
+    mergesort::Sort(beg, buffer.Data(), size, 0, cmp);
+  }
+
+  template < class RAIterator , class T , class A >
+  void g_merge_sort (RAIterator beg, RAIterator end, MergeBuffer<T,A>& buffer)
+  {
+    fsu::LessThan < typename ValueTypeOf<RAIterator>::Type > lt;
+    g_merge_sort(beg, end, buffer, lt);
+  }
+
+  template < class RAIterator , class Comparator >
+  void g_merge_sort (RAIterator beg, RAIterator end, Comparator& cmp)
+  {
+    MergeBuffer < typename ValueTypeOf<RAIterator>::Type > buffer;
+    g_merge_sort(beg, end, buffer, cmp);
+  }
+
   template < class RAIterator >
   void g_merge_sort (RAIterator beg, RAIterator end)
   {
-    // recursive
-    // calls mergesort::Merge (beg, mid, end);
-	size_t size = end - beg;
-	if (size > 1)
-	{
-		RAIterator mid = beg + (size/2);
-		g_merge_sort(beg, mid);
-		g_merge_sort(mid, end);
-		mergesort::Merge(beg, mid, end);
-	}
+    MergeBuffer < typename ValueTypeOf<RAIterator>::Type > buffer;
+    g_merge_sort(beg, end, buffer);
+  }
+
+  template < class RAIterator , class T , class A , class Comparator >
+  void g_merge_sort_bu (RAIterator beg, RAIterator end, MergeBuffer<T,A>& buffer, Comparator& cmp)
+  {
+    size_t size = end - beg;
+    if (size < 2) return;
+    buffer.Reserve(size);
+    T* b = buffer.Data();
+    bool inBuffer = 0; // which side holds the current runs
+    for (size_t w = 1; w < size; w += w)
+    {
+      if (inBuffer)
+        mergesort::MergePass(b, beg, size, w, cmp);
+      else
+        mergesort::MergePass(beg, b, size, w, cmp);
+      inBuffer = !inBuffer;
+    }
+    if (inBuffer) // odd number of passes: one move home at the very end
+    {
+      mergesort::Move(b, b + size, beg);
+      instrument::Move(cmp, size);
+    }
+  }
+
+  template < class RAIterator , class T , class A >
+  void g_merge_sort_bu (RAIterator beg, RAIterator end, MergeBuffer<T,A>& buffer)
+  {
+    fsu::LessThan < typename ValueTypeOf<RAIterator>::Type > lt;
+    g_merge_sort_bu(beg, end, buffer, lt);
   }
 
   template < class RAIterator , class Comparator >
-  void g_merge_sort (RAIterator beg, RAIterator end, Comparator& cmp)
+  void g_merge_sort_bu (RAIterator beg, RAIterator end, Comparator& cmp)
   {
-    // recursive
-    // calls mergesort::Merge (beg, mid, end, cmp);
-	size_t size = end - beg;
-	if (size > 1)
-	{
-		RAIterator mid = beg + size/2;
-		g_merge_sort(beg, mid, cmp);
-		g_merge_sort(mid, end, cmp);
-		mergesort::Merge(beg, mid, end, cmp);
-	}
+    MergeBuffer < typename ValueTypeOf<RAIterator>::Type > buffer;
+    g_merge_sort_bu(beg, end, buffer, cmp);
   }
-  
+
   template < class RAIterator >
   void g_merge_sort_bu (RAIterator beg, RAIterator end)
   {
-	  size_t size = end - beg;
-	  if (size < 2)
-		  return;
-	  for (size_t i = 1; i < size; i+=i)
-	  {
-		  for (size_t j = 0; j < size - i; j += i+i)
-		  {
-			  if (size < j+i+i)
-				  mergesort::Merge(beg+j, beg+j+i, end);
-			  else
-				  mergesort::Merge(beg+j, beg+j+i, beg+j+i+i);
-		  }
-	  }
+    MergeBuffer < typename ValueTypeOf<RAIterator>::Type > buffer;
+    g_merge_sort_bu(beg, end, buffer);
+  }
+
+  // optimized g_merge_sort: snet::LeafSort below policy.cutoff, skips merges
+  // of halves that are already in order
+
+  template < class RAIterator , class T , class A , class Comparator , class B >
+  void g_merge_sort_opt (RAIterator beg, RAIterator end, MergeBuffer<T,A>& buffer, Comparator& cmp,
+                         const SortPolicy<B>& policy)
+  {
+    size_t size = end - beg;
+    if (size < 2) return;
+    buffer.Reserve(size);
+    mergesort::SortOpt(beg, buffer.Data(), size, 0, policy.cutoff, cmp);
+  }
+
+  template < class RAIterator , class Comparator , class A >
+  void g_merge_sort_opt (RAIterator beg, RAIterator end, Comparator& cmp, const SortPolicy<A>& policy)
+  {
+    MergeBuffer < typename ValueTypeOf<RAIterator>::Type , A > buffer;
+    g_merge_sort_opt(beg, end, buffer, cmp, policy);
+  }
+
+  template < class RAIterator , class T , class A , class Comparator >
+  void g_merge_sort_opt (RAIterator beg, RAIterator end, MergeBuffer<T,A>& buffer, Comparator& cmp)
+  {
+    SortPolicy<A> policy(TunedPolicy<T>::Merge(end - beg));
+    g_merge_sort_opt(beg, end, buffer, cmp, policy);
+  }
+
+  template < class RAIterator , class T , class A >
+  void g_merge_sort_opt (RAIterator beg, RAIterator end, MergeBuffer<T,A>& buffer)
+  {
+    fsu::LessThan < typename ValueTypeOf<RAIterator>::Type > lt;
+    g_merge_sort_opt(beg, end, buffer, lt);
   }
 
   template < class RAIterator , class Comparator >
-  void g_merge_sort_bu (RAIterator beg, RAIterator end, Comparator& cmp)
+  void g_merge_sort_opt (RAIterator beg, RAIterator end, Comparator& cmp)
   {
-	  size_t size = end - beg;
-	  if (size < 2)
-		  return;
-	  for (size_t i = 1; i < size; i+=i)
-	  {
-		  for (size_t j = 0; j < size - i; j += i+i)
-		  {
-			  if (size < j+i+i)
-				  mergesort::Merge(beg+j, beg+j+i, end, cmp);
-			  else
-				  mergesort::Merge(beg+j, beg+j+i, beg+j+i+i, cmp);
-		  }
-	  }	  
-  }
-  
-  //optimised g_merge_sort
-  //still needs optimization
-  
+    MergeBuffer < typename ValueTypeOf<RAIterator>::Type > buffer;
+    g_merge_sort_opt(beg, end, buffer, cmp);
+  }
+
   template < class RAIterator >
   void g_merge_sort_opt (RAIterator beg, RAIterator end)
   {
-    // recursive
-    // calls mergesort::Merge (beg, mid, end);
-	size_t size = end - beg;
-	cutoff = 8;
-	RAIterator mid = beg + (size/2);
-	
-	if (size > 1)
-	{
-		if ((mid - beg) > cutoff)
-			g_merge_sort_opt(beg, mid);
-		else
-			g_insertion_sort(beg, mid);
-		if ((end - mid) > cutoff)
-			g_merge_sort_opt(mid, end);
-		else
-			g_insertion_sort(mid, end);
-	}
-	if (*mid < *(mid-1))
-		mergesort::Merge(beg, mid, end);
+    MergeBuffer < typename ValueTypeOf<RAIterator>::Type > buffer;
+    g_merge_sort_opt(beg, end, buffer);
+  }
+
+  namespace timsort
+  {
+
+    // Natural merge sort after Tim Peters' listsort: the input is cut into
+    // the runs already present in it, short runs are extended to a minimum
+    // length by binary insertion, and the runs are merged from a stack whose
+    // lengths are kept roughly Fibonacci, so merges stay balanced. A merge
+    // that keeps taking from the same side switches to galloping
+    // (exponential search), which moves whole blocks at a time.
+
+    const size_t min_merge  = 32; // shorter ranges are one binary insertion sort
+    const size_t min_gallop = 7;  // wins in a row before a merge starts galloping
+    const size_t max_runs   = 85; // run stack depth; enough for 2^64 elements
+
+    // minimum run length: n / minrun is a power of 2 or just under one,
+    // with minrun in [min_merge/2, min_merge]
+    inline size_t MinRun (size_t n)
+    {
+      size_t r = 0;
+      while (n >= min_merge)
+      {
+        r |= n & 1;
+        n >>= 1;
+      }
+      return n + r;
+    }
+
+    template < class I >
+    void Reverse (I beg, I end)
+    {
+      for (--end; beg < end; ++beg, --end)
+        g_XC(*beg, *end);
+    }
+
+    // length of the run at the front of [beg,end); a strictly descending
+    // run is reversed in place (strictly, so that stability is kept)
+    template < class I , class P >
+    size_t CountRun (I beg, I end, P& cmp)
+    {
+      I i = beg + 1;
+      if (i == end)
+        return 1;
+      if (cmp(*i, *beg))
+      {
+        do ++i; while (i != end && cmp(*i, *(i - 1)));
+        Reverse(beg, i);
+        instrument::Swap(cmp, (i - beg) >> 1);
+      }
+      else
+      {
+        do ++i; while (i != end && !cmp(*i, *(i - 1)));
+      }
+      return i - beg;
+    }
+
+    // Pre:  [beg,start) is sorted
+    // Post: [beg,end) is sorted; each element goes after any equal ones
+    template < class I , class P >
+    void BinaryInsertion (I beg, I start, I end, P& cmp)
+    {
+      for ( ; start != end; ++start)
+      {
+        typename ValueTypeOf<I>::Type t(std::move(*start));
+        I lo = beg, hi = start;
+        while (lo < hi)
+        {
+          I mid = lo + ((hi - lo) >> 1);
+          if (cmp(t, *mid)) hi = mid;
+          else              lo = mid + 1;
+        }
+        for (I j = start; j != lo; --j)
+          *j = std::move(*(j - 1));
+        *lo = std::move(t);
+        instrument::Move(cmp, 2 + (start - lo));
+      }
+    }
+
+    // number of elements of sorted a[0,n) that are <= key, found by
+    // exponential search from the front then binary search
+    template < class I , typename T , class P >
+    size_t GallopRight (const T& key, I a, size_t n, P& cmp)
+    {
+      size_t lo = 0, hi = 1;
+      while (hi < n && !cmp(key, a[hi - 1]))
+      {
+        lo = hi;
+        hi = 2 * hi + 1;
+      }
+      if (hi > n) hi = n;
+      while (lo < hi)
+      {
+        size_t m = lo + ((hi - lo) >> 1);
+        if (cmp(key, a[m])) hi = m;
+        else                lo = m + 1;
+      }
+      return lo;
+    }
+
+    // number of elements of sorted a[0,n) that are < key
+    template < class I , typename T , class P >
+    size_t GallopLeft (const T& key, I a, size_t n, P& cmp)
+    {
+      size_t lo = 0, hi = 1;
+      while (hi < n && cmp(a[hi - 1], key))
+      {
+        lo = hi;
+        hi = 2 * hi + 1;
+      }
+      if (hi > n) hi = n;
+      while (lo < hi)
+      {
+        size_t m = lo + ((hi - lo) >> 1);
+        if (cmp(a[m], key)) lo = m + 1;
+        else                hi = m;
+      }
+      return lo;
+    }
+
+    template < class I , typename T , class A , class P >
+    class Sorter
+    {
+    public:
+      Sorter (I beg, MergeBuffer<T,A>& buffer, P& cmp)
+        : beg_(beg), buffer_(buffer), cmp_(cmp), minGallop_(min_gallop), runs_(0)
+      {}
+
+      void PushRun (size_t base, size_t len)
+      {
+        base_[runs_] = base;
+        len_[runs_]  = len;
+        ++runs_;
+      }
+
+      // restores, for the top runs X Y Z (Z on top), len X > len Y + len Z
+      // and len Y > len Z, checking one level deeper than listsort did
+      // (de Gouw et al. 2015) so the invariant holds for the whole stack
+      void MergeCollapse ()
+      {
+        while (runs_ > 1)
+        {
+          size_t n = runs_ - 2;
+          if ((n > 0 && len_[n - 1] <= len_[n] + len_[n + 1]) ||
+              (n > 1 && len_[n - 2] <= len_[n - 1] + len_[n]))
+          {
+            if (len_[n - 1] < len_[n + 1])
+              --n;
+          }
+          else if (len_[n] > len_[n + 1])
+            break;
+          MergeAt(n);
+        }
+      }
+
+      void MergeForceCollapse ()
+      {
+        while (runs_ > 1)
+        {
+          size_t n = runs_ - 2;
+          if (n > 0 && len_[n - 1] < len_[n + 1])
+            --n;
+          MergeAt(n);
+        }
+      }
+
+    private:
+      // merges runs i and i + 1 of the stack
+      void MergeAt (size_t i)
+      {
+        I a = beg_ + base_[i];
+        size_t na = len_[i];
+        I b = beg_ + base_[i + 1];
+        size_t nb = len_[i + 1];
+        len_[i] = na + nb;
+        for (size_t j = i + 1; j + 1 < runs_; ++j)
+        {
+          base_[j] = base_[j + 1];
+          len_[j]  = len_[j + 1];
+        }
+        --runs_;
+
+        // elements of a that go before all of b, and elements of b that go
+        // after all of a, are already where they belong
+        size_t k = GallopRight(*b, a, na, cmp_);
+        a += k;
+        na -= k;
+        if (na == 0)
+          return;
+        nb = GallopLeft(*(a + (na - 1)), b, nb, cmp_);
+        if (nb == 0)
+          return;
+        MergeLo(a, na, b, nb);
+      }
+
+      // a[0,na) is moved to the buffer and merged with b[0,nb) (which
+      // follows it) into a[0,na+nb), front to back
+      void MergeLo (I a, size_t na, I b, size_t nb)
+      {
+        buffer_.Reserve(na);
+        T* pa = buffer_.Data();
+        T* ea = pa + na;
+        mergesort::Move(a, a + na, pa);
+        I dest = a, pb = b, eb = b + nb;
+
+        while (pa != ea && pb != eb)
+        {
+          size_t winsA = 0, winsB = 0; // wins in a row
+          // one element at a time, until one side keeps winning
+          while (pa != ea && pb != eb && winsA < minGallop_ && winsB < minGallop_)
+          {
+            if (cmp_(*pb, *pa))
+            {
+              *dest++ = std::move(*pb++);
+              ++winsB; winsA = 0;
+            }
+            else
+            {
+              *dest++ = std::move(*pa++);
+              ++winsA; winsB = 0;
+            }
+          }
+          // galloping: find how far each side's lead goes, and move it as a block
+          bool galloping = (pa != ea && pb != eb);
+          while (galloping)
+          {
+            winsA = GallopRight(*pb, pa, ea - pa, cmp_);
+            dest = mergesort::Move(pa, pa + winsA, dest);
+            pa += winsA;
+            if (pa == ea) break;
+            *dest++ = std::move(*pb++);
+            if (pb == eb) break;
+
+            winsB = GallopLeft(*pa, pb, eb - pb, cmp_);
+            for (size_t k = 0; k < winsB; ++k)
+              *dest++ = std::move(*pb++);
+            if (pb == eb) break;
+            *dest++ = std::move(*pa++);
+            if (pa == ea) break;
+
+            if (minGallop_ > 1) --minGallop_;
+            galloping = (winsA >= min_gallop || winsB >= min_gallop);
+            if (!galloping)
+              minGallop_ += 2; // galloping did not pay; make it harder to get back into
+          }
+        }
+        mergesort::Move(pa, ea, dest); // what is left of b is already in place
+        instrument::Move(cmp_, na + na + (pb - b)); // a out and back, b as far as it went
+      }
+
+      Sorter (const Sorter&);            // disallowed
+      Sorter& operator = (const Sorter&); // disallowed
+
+      I                 beg_;
+      MergeBuffer<T,A>& buffer_;
+      P&                cmp_;
+      size_t            minGallop_;
+      size_t            base_ [max_runs];
+      size_t            len_ [max_runs];
+      size_t            runs_;
+    };
+
+  } // namespace timsort
+
+  // adaptive (natural) merge sort: stable, Theta(n) on sorted or reverse
+  // sorted input and O(n log n) always. The buffer is only allocated if a
+  // merge is needed, and only as large as the longest left-hand run merged.
+
+  template < class RAIterator , class T , class A , class Comparator >
+  void g_merge_sort_adaptive (RAIterator beg, RAIterator end, MergeBuffer<T,A>& buffer, Comparator& cmp)
+  {
+    size_t n = end - beg;
+    if (n < 2) return;
+    if (n < timsort::min_merge)
+    {
+      size_t run = timsort::CountRun(beg, end, cmp);
+      timsort::BinaryInsertion(beg, beg + run, end, cmp);
+      return;
+    }
+    timsort::Sorter < RAIterator , T , A , Comparator > sorter(beg, buffer, cmp);
+    size_t minRun = timsort::MinRun(n);
+    size_t base = 0;
+    while (base < n)
+    {
+      RAIterator b = beg + base;
+      size_t run = timsort::CountRun(b, end, cmp);
+      if (run < minRun)
+      {
+        size_t forced = (n - base < minRun) ? n - base : minRun;
+        timsort::BinaryInsertion(b, b + run, b + forced, cmp);
+        run = forced;
+      }
+      sorter.PushRun(base, run);
+      sorter.MergeCollapse();
+      base += run;
+    }
+    sorter.MergeForceCollapse();
+  }
+
+  template < class RAIterator , class T , class A >
+  void g_merge_sort_adaptive (RAIterator beg, RAIterator end, MergeBuffer<T,A>& buffer)
+  {
+    fsu::LessThan < typename ValueTypeOf<RAIterator>::Type > lt;
+    g_merge_sort_adaptive(beg, end, buffer, lt);
   }
 
   template < class RAIterator , class Comparator >
-  void g_merge_sort_opt (RAIterator beg, RAIterator end, Comparator& cmp)
+  void g_merge_sort_adaptive (RAIterator beg, RAIterator end, Comparator& cmp)
   {
-    // recursive
-    // calls mergesort::Merge (beg, mid, end, cmp);
-	size_t size = end - beg;
-	cutoff = 8;
-	RAIterator mid = beg + (size/2);
-	
-	if (size > 1)
-	{
-		if ((mid - beg) > cutoff)
-			g_merge_sort_opt(beg, mid, cmp);
-		else
-			g_insertion_sort(beg, mid, cmp);
-		if ((end - mid) > cutoff)
-			g_merge_sort_opt(mid, end, cmp);
-		else
-			g_insertion_sort(mid, end, cmp);
-	}
-	if (cmp(*(mid-1), *mid))
-	{
-		//do nothing
-	} else {
-		mergesort::Merge(beg, mid, end, cmp);
-	}
+    MergeBuffer < typename ValueTypeOf<RAIterator>::Type > buffer;
+    g_merge_sort_adaptive(beg, end, buffer, cmp);
+  }
+
+  template < class RAIterator >
+  void g_merge_sort_adaptive (RAIterator beg, RAIterator end)
+  {
+    MergeBuffer < typename ValueTypeOf<RAIterator>::Type > buffer;
+    g_merge_sort_adaptive(beg, end, buffer);
   }
-  // Note: specializations of mergesort::Merge are needed to handle pointer
-  // cases, but specializations are not needed for g_merge_sort itself
 
   namespace quicksort
   {
@@ -301,30 +762,184 @@ namespace fsu
       {
         if (!(*last < *j)) // if (*j <= *last)
         {
-          Swap(*pivot,*j);
+          g_XC(*pivot,*j);
           ++pivot;
         }
       }
-      Swap (*pivot,*last);
+      g_XC (*pivot,*last);
       return pivot;
     }
 
     template < class IterType , class P >
-    IterType Partition (IterType first, IterType last, P& cmp) // closed range [first,last]
+    IterType LomutoPartition (IterType first, IterType last, P& cmp) // closed range [first,last]
     {
       IterType pivot = first;
       for (IterType j = first; j != last; ++j)
 	  {
 		if (!(cmp(*last, *j)))
 		{
-			Swap(*pivot, *j);
+			instrument::XC(*pivot, *j, cmp);
 			++pivot;
 		}
 	  }
-	  Swap (*pivot, *last);
+	  instrument::XC (*pivot, *last, cmp);
       return pivot;
     }
 
+    template < class IterType , class P >
+    IterType Partition (IterType first, IterType last, P& cmp) // closed range [first,last]
+    {
+      return LomutoPartition(first, last, cmp);
+    }
+
+    // block partition (Edelkamp & Weiss, "BlockQuicksort"), pivot *last
+    // Lomuto's "if (!(*last < *j))" is a coin flip on random data, so about
+    // half of those branches are mispredicted. Here each block of the left
+    // and right ends is scanned without branching, recording the offsets of
+    // elements on the wrong side, and the recorded elements are then swapped
+    // in a batch. The only branches left are loop control.
+    // Post: [first,p) < pivot == *p <= (p,last]
+    const size_t block = 128; // offsets fit in an unsigned char
+
+    template < typename T , class P >
+    T* BlockPartition (T* first, T* last, P& cmp) // closed range [first,last]
+    {
+      T pivot = *last;
+      T* l = first;     // [first,l) < pivot
+      T* r = last - 1;  // (r,last) >= pivot
+      unsigned char offL [block], offR [block];
+      size_t numL = 0, numR = 0, startL = 0, startR = 0;
+      while (r - l >= (std::ptrdiff_t)(2 * block)) // two disjoint blocks remain in [l,r]
+      {
+        if (numL == 0)
+        {
+          startL = 0;
+          for (size_t i = 0; i < block; ++i)
+          {
+            offL[numL] = (unsigned char)i;
+            numL += !cmp(l[i], pivot);
+          }
+        }
+        if (numR == 0)
+        {
+          startR = 0;
+          for (size_t i = 0; i < block; ++i)
+          {
+            offR[numR] = (unsigned char)i;
+            numR += cmp(*(r - i), pivot);
+          }
+        }
+        size_t num = (numL < numR) ? numL : numR;
+        instrument::Swap(cmp, num);
+        for (size_t k = 0; k < num; ++k)
+          g_XC(l[offL[startL + k]], *(r - offR[startR + k]));
+        numL -= num; startL += num;
+        numR -= num; startR += num;
+        if (numL == 0) l += block;
+        if (numR == 0) r -= block;
+      }
+      // at most two partly processed blocks are left in [l,r]; finish them
+      // with an ordinary Hoare scan
+      T* i = l;
+      T* j = r + 1;
+      for (;;)
+      {
+        while (i < j && cmp(*i, pivot))      ++i;
+        while (i < j && !cmp(*(j - 1), pivot)) --j;
+        if (j - i < 2) break;
+        instrument::XC(*i, *(j - 1), cmp);
+        ++i; --j;
+      }
+      instrument::XC(*i, *last, cmp);
+      return i;
+    }
+
+    template < typename T , class P >
+    T* Partition (T* first, T* last, P& cmp, std::true_type)  // trivially copyable
+    {
+      return BlockPartition(first, last, cmp);
+    }
+
+    template < typename T , class P >
+    T* Partition (T* first, T* last, P& cmp, std::false_type) // copying costs too much
+    {
+      return LomutoPartition(first, last, cmp);
+    }
+
+    // specialization for pointers
+    template < typename T , class P >
+    T* Partition (T* first, T* last, P& cmp) // closed range [first,last]
+    {
+      return Partition(first, last, cmp,
+                       std::integral_constant<bool, std::is_trivially_copyable<T>::value>());
+    }
+
+    // specialization for pointers
+    template < typename T >
+    T* Partition (T* first, T* last) // closed range [first,last]
+    {
+      fsu::LessThan < T > lt;
+      return Partition(first, last, lt);
+    }
+
+    const size_t ninther_cutoff = 128; // ranges this long take the pivot from Tukey's ninther
+
+    template < class IterType , class P >
+    IterType Median3 (IterType a, IterType b, IterType c, P& cmp)
+    // returns the position of the median of *a, *b, *c
+    {
+      if (cmp(*a,*b))
+      {
+        if (cmp(*b,*c)) return b;        // a < b < c
+        return (cmp(*a,*c)) ? c : a;     // a < b, c <= b
+      }
+      if (cmp(*a,*c)) return a;          // b <= a < c
+      return (cmp(*b,*c)) ? c : b;       // b <= a, c <= a
+    }
+
+    template < class IterType , class P >
+    void SelectPivot (IterType first, IterType last, PivotRule rule, P& cmp) // closed range [first,last]
+    // moves the pivot chosen by rule to *last, which is where Partition expects it
+    {
+      if (rule == pivot_last)
+        return;
+      size_t n = 1 + (last - first);
+      IterType mid = first + (n >> 1);
+      IterType p;
+      if (rule == pivot_median3 || n < ninther_cutoff)
+      {
+        p = Median3(first, mid, last, cmp);
+      }
+      else // Tukey's ninther: median of the medians of three samples of three
+      {
+        size_t s = n >> 3;
+        p = Median3(Median3(first, first + s, first + (s + s), cmp),
+                    Median3(mid - s, mid, mid + s, cmp),
+                    Median3(last - (s + s), last - s, last, cmp),
+                    cmp);
+      }
+      if (p != last)
+        instrument::XC(*p,*last,cmp);
+    }
+
+    template < class IterType , class P >
+    void Partition3w (IterType first, IterType last, IterType& low, IterType& hih, P& cmp) // closed range [first,last]
+    // 3-way partition about the pivot at *last, where SelectPivot puts it
+    // on return: [first,low) < pivot, [low,hih) == pivot, [hih,last] > pivot
+    {
+      instrument::XC(*first, *last, cmp); // the pivot goes in front, where the scan leaves it
+      typename ValueTypeOf<IterType>::Type v = *first;
+      IterType i = first;
+      low = first;
+      hih = last + 1;
+      while (i != hih)
+      {
+        if (cmp(*i, v))      instrument::XC(*low++, *i++, cmp);
+        else if (cmp(v, *i)) instrument::XC(*i, *--hih, cmp);
+        else                 ++i;
+      }
+    }
+
   } // namespace
 
   template < class IterType >
@@ -347,54 +962,14 @@ namespace fsu
     // calls quicksort::Partition(beg, end, cmp);
 	if (end - beg > 1)
 	{
+		instrument::Level < Comparator > level;
 		IterType q = quicksort::Partition(beg, end-1, cmp);
+		instrument::Partition(cmp, q - beg, end - q - 1);
 		g_quick_sort(beg, q, cmp);
 		g_quick_sort(q+1, end, cmp);
 	}
   }
 
-  // following are the optimized versions
-
-  template < class IterType >
-  void g_quick_sort_opt (IterType beg, IterType end)
-  {
-    // implementation required
-	cutoff = 11;
-	if (end - beg > 1)
-	{
-		if (end - beg > cutoff)
-		{
-			IterType q = quicksort::Partition(beg, end-1);
-			g_quick_sort_opt(beg, q);
-			g_quick_sort_opt(++q, end);
-		}
-		else
-		{
-			g_insertion_sort(beg, end);
-		}
-	}
-  }
-
-  template < class IterType , class Comparator >
-  void g_quick_sort_opt (IterType beg, IterType end, Comparator& cmp)
-  {
-    // implementation required
-	cutoff = 11;
-	if (end - beg > 1)
-	{
-		if (end - beg > cutoff)
-		{
-			IterType q = quicksort::Partition(beg, end-1, cmp);
-			g_quick_sort_opt(beg, q, cmp);
-			g_quick_sort_opt(++q, end, cmp);
-		}
-		else
-		{
-			g_insertion_sort(beg, end, cmp);
-		}
-	}
-  }
-
   template < typename T >
   void g_quick_sort_3w (T* beg, T* end)
   {
@@ -406,8 +981,8 @@ namespace fsu
 		T* i = beg;
 		while (i != hih)
 		{
-			if (*i < v) Swap(*low++, *i++);
-			else if (*i > v) Swap(*i, *--hih);
+			if (*i < v) g_XC(*low++, *i++);
+			else if (*i > v) g_XC(*i, *--hih);
 			else ++i;
 		}
 		g_quick_sort_3w(beg, low);
@@ -420,77 +995,25 @@ namespace fsu
   {
 	  if (end - beg > 1)
 	  {
+		instrument::Level < Comparator > level;
 		T* low = beg;
 		T* hih = end;
 		T v = *beg;
 		T* i = beg;
 		while (i != hih)
 		{
-			if (cmp(*i,v)) Swap(*low++, *i++);
+			if (cmp(*i,v)) instrument::XC(*low++, *i++, cmp);
 			else if (!(cmp(*i, v))) 
 			{
 				if(*i == v) ++i;
-				else Swap(*i, *--hih);
+				else instrument::XC(*i, *--hih, cmp);
 			}
 		}
+		instrument::Partition(cmp, low - beg, end - hih);
 		g_quick_sort_3w(beg, low, cmp);
 		g_quick_sort_3w(hih, end, cmp);
 	  }
   }
-  
-  template < typename T >
-  void g_quick_sort_3w_opt (T* beg, T* end)
-  {
-	  int cutoff = 13;
-	  
-	  if (end-beg > cutoff)
-	  {
-		T* low = beg;
-		T* hih = end;
-		T v = *beg;
-		T* i = beg;
-		while (i != hih)
-		{
-			if (*i < v) Swap(*low++, *i++);
-			else if (*i > v)
-			{
-				if(*i == v) ++i;
-				else Swap(*i, *--hih);
-			}
-		}
-		g_quick_sort_3w_opt(beg, low);
-		g_quick_sort_3w_opt(hih, end);
-	  }
-	  else if(end - beg > 1 && end - beg <= cutoff)
-		  g_insertion_sort(beg, end);
-  }
-
-  template < typename T , class Comparator >
-  void g_quick_sort_3w_opt (T* beg, T* end, Comparator& cmp)
-  {
-	  int cutoff = 13;
-	  
-	  if (end-beg > cutoff)
-	  {
-		T* low = beg;
-		T* hih = end;
-		T v = *beg;
-		T* i = beg;
-		while (i != hih)
-		{
-			if (cmp(*i, v)) Swap(*low++, *i++);
-			else if (!cmp(*i,v))
-			{
-				if(*i == v) ++i;
-				else Swap(*i, *--hih);
-			}
-		}
-		g_quick_sort_3w_opt(beg, low, cmp);
-		g_quick_sort_3w_opt(hih, end, cmp);
-	  }
-	  else if(end - beg > 1 && end - beg <= cutoff)
-		  g_insertion_sort(beg, end, cmp);
-  }
 
   template < class IterType >
   void g_quick_sort_3w (IterType beg, IterType end)
@@ -504,8 +1027,8 @@ namespace fsu
 		IterType i = beg;
 		while (i != hih)
 		{
-			if (*i < v) Swap(*low++, *i++);
-			else if (*i > v) Swap(*i, *--hih);
+			if (*i < v) g_XC(*low++, *i++);
+			else if (*i > v) g_XC(*i, *--hih);
 			else ++i;
 		}
 		g_quick_sort_3w(beg, low);
@@ -519,87 +1042,253 @@ namespace fsu
     // implementation required
 	if (end - beg > 1)
 	{
+		instrument::Level < Comparator > level;
 		IterType low = beg;
 		IterType hih = end;
 		typename IterType::ValueType v = *beg;
 		IterType i = beg;
 		while (i != hih)
 		{
-			if (cmp(*i, v)) Swap(*low++, *i++);
+			if (cmp(*i, v)) instrument::XC(*low++, *i++, cmp);
 			else if (!(cmp(*i, v))) {
 				if (*i == v)
 					++i;
 				else
-					Swap(*i, *--hih);
+					instrument::XC(*i, *--hih, cmp);
 			}
 		}
+		instrument::Partition(cmp, low - beg, end - hih);
 		g_quick_sort_3w(beg, low, cmp);
 		g_quick_sort_3w(hih, end, cmp);
 	}
   }
 
-    template < class IterType >
-  void g_quick_sort_3w_opt (IterType beg, IterType end)
+  namespace introsort
   {
-    // implementation required
-	cutoff = 13;
-	if(end - beg > 1)
-	{
-		if(end - beg > cutoff)
-		{
-			IterType low = beg;
-			IterType hih = end;
-			typename IterType::ValueType v = *beg;
-			IterType i = beg;
-			while (i != hih)
-			{
-				if (*i < v) Swap(*low++, *i++);
-				else if (*i > v) Swap(*i, *--hih);
-				else ++i;
-			}
-			g_quick_sort_3w_opt(beg, low);
-			g_quick_sort_3w_opt(hih, end);
-		}
-		else if(end - beg > 1 && end - beg <= cutoff)
-		{
-			g_insertion_sort(beg, end);
-		}
-	}
+
+    // namespace supporting introsort
+    // NOTE that, as in namespace quicksort, iterators define closed ranges [p,r]
+
+    inline size_t DepthLimit (size_t n)
+    // 2 * floor(log2(n))
+    {
+      size_t depth = 0;
+      for ( ; n > 1; n >>= 1)
+        ++depth;
+      return depth << 1;
+    }
+
+    template < class IterType , class P , class A >
+    void Sort (IterType beg, IterType end, size_t depth, P& cmp, const SortPolicy<A>& policy) // half-open range [beg,end)
+    {
+      instrument::Level < P > level;
+      while ((size_t)(end - beg) > policy.cutoff && end - beg > 1)
+      {
+        if (depth == 0) // partitioning has gone bad - give the rest to heapsort
+        {
+          g_heap_sort(beg, end, cmp);
+          return;
+        }
+        --depth;
+        quicksort::SelectPivot(beg, end - 1, policy.pivot, cmp);
+        IterType q = quicksort::Partition(beg, end - 1, cmp);
+        instrument::Partition(cmp, q - beg, end - q - 1);
+        // recurse on the smaller side and loop on the larger,
+        // so the call stack never grows past log2(n)
+        if (q - beg < end - q)
+        {
+          Sort(beg, q, depth, cmp, policy);
+          beg = q + 1;
+        }
+        else
+        {
+          Sort(q + 1, end, depth, cmp, policy);
+          end = q;
+        }
+      }
+      if (end - beg > 1)
+        snet::LeafSort(beg, end, cmp);
+    }
+
+    template < class IterType , class P , class A >
+    void Sort3w (IterType beg, IterType end, size_t depth, P& cmp, const SortPolicy<A>& policy) // half-open range [beg,end)
+    // Sort on the 3-way partition: the run equal to the pivot is done
+    {
+      instrument::Level < P > level;
+      while ((size_t)(end - beg) > policy.cutoff && end - beg > 1)
+      {
+        if (depth == 0) // partitioning has gone bad - give the rest to heapsort
+        {
+          g_heap_sort(beg, end, cmp);
+          return;
+        }
+        --depth;
+        quicksort::SelectPivot(beg, end - 1, policy.pivot, cmp);
+        IterType low, hih;
+        quicksort::Partition3w(beg, end - 1, low, hih, cmp);
+        instrument::Partition(cmp, low - beg, end - hih);
+        // [beg,low) < v, [low,hih) == v, [hih,end) > v
+        if (low - beg < end - hih)
+        {
+          Sort3w(beg, low, depth, cmp, policy);
+          beg = hih;
+        }
+        else
+        {
+          Sort3w(hih, end, depth, cmp, policy);
+          end = low;
+        }
+      }
+      if (end - beg > 1)
+        snet::LeafSort(beg, end, cmp);
+    }
+
+    template < class IterType , class P , class A >
+    void Select (IterType beg, IterType nth, IterType end, size_t depth, P& cmp, const SortPolicy<A>& policy) // half-open range [beg,end)
+    // introselect: partition, then go on with the side that holds nth only
+    {
+      while ((size_t)(end - beg) > policy.cutoff && end - beg > 1)
+      {
+        if (depth == 0) // partitioning has gone bad - select by heap
+        {
+          g_partial_sort(beg, nth + 1, end, cmp);
+          return;
+        }
+        --depth;
+        quicksort::SelectPivot(beg, end - 1, policy.pivot, cmp);
+        IterType low, hih;
+        quicksort::Partition3w(beg, end - 1, low, hih, cmp);
+        instrument::Partition(cmp, low - beg, end - hih);
+        ptrdiff_t k = nth - beg; // by differences: an iterator need not have <
+        if (k < low - beg)
+          end = low;
+        else if (k >= hih - beg)
+          beg = hih;
+        else // nth is equal to the pivot: in place
+          return;
+      }
+      if (end - beg > 1)
+        snet::LeafSort(beg, end, cmp);
+    }
+
+  } // namespace introsort
+
+  // following are the optimized versions: pivot from policy.pivot, ranges
+  // of policy.cutoff or fewer elements finished by snet::LeafSort, and the
+  // loop of introsort below (recursion into the smaller side, heapsort past
+  // a 2*log2(n) depth), so no pivot rule can make them quadratic or run the
+  // stack out
+
+  template < class IterType , class Comparator , class A >
+  void g_quick_sort_opt (IterType beg, IterType end, Comparator& cmp, const SortPolicy<A>& policy)
+  {
+	if (end - beg > 1)
+		introsort::Sort(beg, end, introsort::DepthLimit(end - beg), cmp, policy);
+  }
+
+  template < class IterType , class Comparator >
+  void g_quick_sort_opt (IterType beg, IterType end, Comparator& cmp)
+  {
+	SortPolicy<> policy = TunedPolicy < typename ValueTypeOf<IterType>::Type >::Quick(end - beg);
+	g_quick_sort_opt(beg, end, cmp, policy);
+  }
+
+  template < class IterType >
+  void g_quick_sort_opt (IterType beg, IterType end)
+  {
+	fsu::LessThan < typename ValueTypeOf<IterType>::Type > lt;
+	g_quick_sort_opt(beg, end, lt);
+  }
+
+  template < class IterType , class Comparator , class A >
+  void g_quick_sort_3w_opt (IterType beg, IterType end, Comparator& cmp, const SortPolicy<A>& policy)
+  {
+	if (end - beg > 1)
+		introsort::Sort3w(beg, end, introsort::DepthLimit(end - beg), cmp, policy);
   }
 
   template < class IterType , class Comparator >
   void g_quick_sort_3w_opt (IterType beg, IterType end, Comparator& cmp)
   {
-    // implementation required
-	cutoff = 13;
-	if(end - beg > 1)
-	{
-		if(end - beg > cutoff)
-		{
-			IterType low = beg;
-			IterType hih = end;
-			typename IterType::ValueType v = *beg;
-			IterType i = beg;
-			while (i != hih)
-			{
-				if (cmp(*i, v)) Swap(*low++, *i++);
-				else if (!(cmp(*i, v))) 
-				{
-					if(*i == v)
-						++i;
-					else
-						Swap(*i, *--hih);
-				}
-			}
-			g_quick_sort_3w_opt(beg, low, cmp);
-			g_quick_sort_3w_opt(hih, end, cmp);
-		}
-		else if(end - beg > 1 && end - beg <= cutoff)
-		{
-			g_insertion_sort(beg, end, cmp);
-		}
-	}
+	SortPolicy<> policy = TunedPolicy < typename ValueTypeOf<IterType>::Type >::Quick(end - beg);
+	g_quick_sort_3w_opt(beg, end, cmp, policy);
+  }
+
+  template < class IterType >
+  void g_quick_sort_3w_opt (IterType beg, IterType end)
+  {
+	fsu::LessThan < typename ValueTypeOf<IterType>::Type > lt;
+	g_quick_sort_3w_opt(beg, end, lt);
+  }
+
+  // introsort: quicksort with median-of-3 (ninther for long ranges) pivots,
+  // a 2*log2(n) recursion depth limit after which the range is heap sorted,
+  // and snet::LeafSort to finish short ranges. Worst case Theta(n log n).
+
+  template < class IterType , class Comparator , class A >
+  void g_intro_sort (IterType beg, IterType end, Comparator& cmp, const SortPolicy<A>& policy)
+  {
+    if (end - beg > 1)
+      introsort::Sort(beg, end, introsort::DepthLimit(end - beg), cmp, policy);
+  }
+
+  template < class IterType , class Comparator >
+  void g_intro_sort (IterType beg, IterType end, Comparator& cmp)
+  {
+    SortPolicy<> policy = TunedPolicy < typename IterType::ValueType >::Quick(end - beg);
+    g_intro_sort(beg, end, cmp, policy);
+  }
+
+  template < class IterType >
+  void g_intro_sort (IterType beg, IterType end)
+  {
+    fsu::LessThan < typename IterType::ValueType > lt;
+    g_intro_sort(beg, end, lt);
+  }
+
+  // specialization for pointers
+  template < typename T , class Comparator >
+  void g_intro_sort (T* beg, T* end, Comparator& cmp)
+  {
+    SortPolicy<> policy = TunedPolicy<T>::Quick(end - beg);
+    g_intro_sort(beg, end, cmp, policy);
+  }
+
+  // specialization for pointers
+  template < typename T >
+  void g_intro_sort (T* beg, T* end)
+  {
+    fsu::LessThan < T > lt;
+    g_intro_sort(beg, end, lt);
+  }
+
+  // nth_element: puts in *nth the element a sort would put there, with
+  // none after it that comes before it and none before it that comes after.
+  // Introselect on the 3-way partition of g_quick_sort_3w_opt: O(n) on
+  // average, and after 2*log2(n) partitions the rest is selected by
+  // g_partial_sort, so never worse than O(n log n). nth == end does nothing.
+
+  template < class IterType , class Comparator , class A >
+  void g_nth_element (IterType beg, IterType nth, IterType end, Comparator& cmp, const SortPolicy<A>& policy)
+  {
+    if (nth != end && end - beg > 1)
+      introsort::Select(beg, nth, end, introsort::DepthLimit(end - beg), cmp, policy);
+  }
+
+  template < class IterType , class Comparator >
+  void g_nth_element (IterType beg, IterType nth, IterType end, Comparator& cmp)
+  {
+    SortPolicy<> policy = TunedPolicy < typename ValueTypeOf<IterType>::Type >::Quick(end - beg);
+    g_nth_element(beg, nth, end, cmp, policy);
+  }
+
+  template < class IterType >
+  void g_nth_element (IterType beg, IterType nth, IterType end)
+  {
+    fsu::LessThan < typename ValueTypeOf<IterType>::Type > lt;
+    g_nth_element(beg, nth, end, lt);
   }
-  // note: missing are g_merge_sort_opt, g_merge_sort_bu, g_quick_sort_3w_opt
 
 } // namespace fsu
+
+#endif
@@ -0,0 +1,315 @@
+/*
+    gsort_auto.h
+    10/19/26
+
+    g_sort: a front end that looks at the input and picks the sort
+
+      SortDecision d = fsu::g_sort (beg, end [, cmp]);  // sorts, returns what it did
+      SortDecision d = fsu::g_sort_plan (beg, end [, cmp]); // only looks
+
+    A few hundred sampled positions give the shape of the data:
+
+      runs        - descents between sampled neighbours, scaled up to an
+                    estimate of the number of ascending runs
+      duplicates  - equal neighbours in the sorted sample
+      key range   - max - min + 1, by one pass over integer keys
+      element size
+
+    and the range goes to the first of these that fits:
+
+      SortDecision::counting      integer keys spanning at most 2n values
+      SortDecision::natural_merge nearly sorted, or nearly reverse sorted
+                                  (few runs): g_merge_sort_adaptive
+      SortDecision::quick3w       heavy duplicates
+      SortDecision::radix         long ranges of integer, float or double keys:
+                                  radix_sort
+      SortDecision::intro         anything else, and all short ranges
+
+    Counting and radix sort need the keys themselves, so they are only
+    considered for arrays of integers (radix also float and double) in
+    default order (no predicate, or fsu::LessThan). Every other range is
+    sorted by comparisons alone.
+
+    SortDecision records the measurements along with the choice, so a
+    caller can log why a range was sorted the way it was:
+
+      std::clog << fsu::g_sort(a, a + n) << '\n';
+*/
+
+#ifndef _GSORT_AUTO_H
+#define _GSORT_AUTO_H
+
+#include <cstdlib>   // size_t
+#include <cstdint>
+#include <iostream>
+#include <type_traits>
+#include <genalg.h>  // g_copy
+#include <compare.h> // LessThan
+#include <nsort.h>   // counting_sort
+#include <rsort.h>   // radix_sort
+#include <gsort.h>
+
+namespace fsu
+{
+
+  struct SortDecision
+  {
+    enum Algorithm { none, counting, radix, quick3w, natural_merge, intro };
+
+    Algorithm algorithm;
+    size_t    size;        // elements in the range
+    size_t    sampled;     // neighbour pairs sampled
+    size_t    descents;    // sampled pairs out of order
+    size_t    runs;        // estimated ascending runs in the whole range
+    size_t    duplicates;  // equal neighbours in the sorted sample
+    uint64_t  keyRange;    // max - min + 1 of integer keys; 0 if not measured
+    size_t    elementSize; // sizeof the element type
+
+    SortDecision () : algorithm(none), size(0), sampled(0), descents(0), runs(0),
+                      duplicates(0), keyRange(0), elementSize(0) {}
+
+    const char* Name () const
+    {
+      switch (algorithm)
+      {
+        case counting:      return "counting_sort";
+        case radix:         return "radix_sort";
+        case quick3w:       return "g_quick_sort_3w_opt";
+        case natural_merge: return "g_merge_sort_adaptive";
+        case intro:         return "g_intro_sort";
+        default:            return "none";
+      }
+    }
+  };
+
+  inline std::ostream& operator << (std::ostream& os, const SortDecision& d)
+  {
+    os << d.Name() << " (size " << d.size << ", runs ~" << d.runs
+       << ", duplicates " << d.duplicates << '/' << d.sampled;
+    if (d.keyRange != 0)
+      os << ", key range " << d.keyRange;
+    return os << ", element " << d.elementSize << " bytes)";
+  }
+
+  namespace adaptive
+  {
+
+    const size_t small_size     = 1024;     // shorter ranges go straight to introsort
+    const size_t sample_size    = 256;      // neighbour pairs sampled
+    const size_t sorted_ratio   = 16;       // at most 1 descent (or ascent) per this many pairs: nearly (reverse) sorted
+    const size_t dup_ratio      = 4;        // at least 1 equal pair per this many: heavy duplicates
+    const size_t counting_span  = 2;        // counting sort for key ranges up to this many times n
+    const size_t radix_size     = 65536;    // radix sort pays off from here for 4-byte keys
+
+    // integer keys that counting and radix sort can handle
+    template < typename T >
+    struct IntegerKeys
+    {
+      static const bool value = std::is_integral<T>::value && !std::is_same<T,bool>::value;
+    };
+
+    // keys radix sort can handle
+    template < typename T >
+    struct RadixKeys
+    {
+      static const bool value = IntegerKeys<T>::value
+                                || std::is_same<T,float>::value || std::is_same<T,double>::value;
+    };
+
+    // fills in the sampled measurements
+    template < class I , class P >
+    void Sample (I beg, size_t n, P& cmp, SortDecision& d)
+    {
+      typedef typename ValueTypeOf<I>::Type T;
+      size_t pairs = (n - 1 < sample_size) ? n - 1 : sample_size;
+      T sample [sample_size];
+      d.sampled = pairs;
+      for (size_t k = 0; k < pairs; ++k)
+      {
+        size_t i = (size_t)(((unsigned long long)k * (n - 1)) / pairs); // 0 <= i < n - 1
+        if (cmp(beg[i + 1], beg[i]))
+          ++d.descents;
+        sample[k] = beg[i];
+      }
+      d.runs = 1 + (size_t)(((unsigned long long)d.descents * (n - 1)) / pairs);
+      g_intro_sort(sample, sample + pairs, cmp);
+      for (size_t k = 1; k < pairs; ++k)
+        if (!cmp(sample[k - 1], sample[k]))
+          ++d.duplicates;
+    }
+
+    // the choice among the comparison sorts
+    inline void Decide (SortDecision& d)
+    {
+      if (d.descents * sorted_ratio <= d.sampled)
+        d.algorithm = SortDecision::natural_merge;
+      else if ((d.sampled - d.descents) * sorted_ratio <= d.sampled // descending runs are reversed in place
+               && d.duplicates * dup_ratio < d.sampled)            // but equal keys would break them up
+        d.algorithm = SortDecision::natural_merge;
+      else if (d.duplicates * dup_ratio >= d.sampled)
+        d.algorithm = SortDecision::quick3w;
+      else
+        d.algorithm = SortDecision::intro;
+    }
+
+    // comparison sorts only
+    template < class I , class P >
+    SortDecision Plan (I beg, I end, P& cmp, std::false_type)
+    {
+      SortDecision d;
+      d.size        = end - beg;
+      d.elementSize = sizeof(typename ValueTypeOf<I>::Type);
+      if (d.size < small_size)
+      {
+        d.algorithm = (d.size < 2) ? SortDecision::none : SortDecision::intro;
+        return d;
+      }
+      Sample(beg, d.size, cmp, d);
+      Decide(d);
+      return d;
+    }
+
+    // integer keys: max - min + 1
+    template < typename T >
+    void KeyRange (const T* beg, const T* end, SortDecision& d, std::true_type)
+    {
+      T min = *beg, max = *beg;
+      for (const T* i = beg + 1; i != end; ++i)
+      {
+        if (*i < min) min = *i;
+        if (max < *i) max = *i;
+      }
+      d.keyRange = (uint64_t)max - (uint64_t)min + 1; // 0 if it spans all 64 bits
+    }
+
+    // floating keys: no counting sort, keyRange stays 0
+    template < typename T >
+    void KeyRange (const T*, const T*, SortDecision&, std::false_type)
+    {}
+
+    // keys in default order: counting (integers) and radix sort are candidates too
+    template < typename T , class P >
+    SortDecision Plan (T* beg, T* end, P& cmp, std::true_type)
+    {
+      SortDecision d;
+      d.size        = end - beg;
+      d.elementSize = sizeof(T);
+      if (d.size < small_size)
+      {
+        d.algorithm = (d.size < 2) ? SortDecision::none : SortDecision::intro;
+        return d;
+      }
+      Sample(beg, d.size, cmp, d);
+      KeyRange(beg, end, d, std::integral_constant<bool, IntegerKeys<T>::value>());
+      if (d.keyRange != 0 && d.keyRange <= counting_span * d.size)
+      {
+        d.algorithm = SortDecision::counting;
+        return d;
+      }
+      Decide(d);
+      // radix sort makes one pass per 11-bit digit of key
+      if (d.algorithm == SortDecision::intro && d.size >= radix_size * sizeof(T) / 4)
+        d.algorithm = SortDecision::radix;
+      return d;
+    }
+
+    // maps a key to its counter in counting_sort
+    template < typename T >
+    class Offset
+    {
+    public:
+      explicit Offset (T min) : min_(min) {}
+      size_t operator () (T t) const { return (size_t)((uint64_t)t - (uint64_t)min_); }
+    private:
+      T min_;
+    };
+
+    template < typename T >
+    void Count (T* beg, T* end, const SortDecision& d, std::true_type)
+    {
+      T min = *beg;
+      for (T* i = beg + 1; i != end; ++i)
+        if (*i < min) min = *i;
+      T* b = new T [d.size];
+      Offset<T> f(min);
+      counting_sort(beg, b, d.size, (size_t)d.keyRange, f);
+      g_copy(b, b + d.size, beg);
+      delete [] b;
+    }
+
+    // Plan never picks counting for floating keys
+    template < typename T >
+    void Count (T*, T*, const SortDecision&, std::false_type)
+    {}
+
+    template < class I , class P >
+    void Run (I beg, I end, P& cmp, const SortDecision& d, std::false_type)
+    {
+      switch (d.algorithm)
+      {
+        case SortDecision::natural_merge: g_merge_sort_adaptive(beg, end, cmp); break;
+        case SortDecision::quick3w:       g_quick_sort_3w_opt(beg, end, cmp);   break;
+        case SortDecision::intro:         g_intro_sort(beg, end, cmp);          break;
+        default:                          break;
+      }
+    }
+
+    template < typename T , class P >
+    void Run (T* beg, T* end, P& cmp, const SortDecision& d, std::true_type)
+    {
+      if (d.algorithm == SortDecision::counting)
+        Count(beg, end, d, std::integral_constant<bool, IntegerKeys<T>::value>());
+      else if (d.algorithm == SortDecision::radix)
+        radix_sort(beg, d.size);
+      else
+        Run(beg, end, cmp, d, std::false_type());
+    }
+
+    template < class I , class P >
+    struct Keyed // whether Plan and Run may look at the keys
+    {
+      typedef std::false_type Type;
+    };
+
+    template < typename T >
+    struct Keyed < T* , fsu::LessThan<T> >
+    {
+      typedef std::integral_constant<bool, RadixKeys<T>::value> Type;
+    };
+
+  } // namespace adaptive
+
+  template < class IterType , class Comparator >
+  SortDecision g_sort_plan (IterType beg, IterType end, Comparator& cmp)
+  {
+    return adaptive::Plan(beg, end, cmp, typename adaptive::Keyed<IterType,Comparator>::Type());
+  }
+
+  template < class IterType >
+  SortDecision g_sort_plan (IterType beg, IterType end)
+  {
+    fsu::LessThan < typename ValueTypeOf<IterType>::Type > lt;
+    return g_sort_plan(beg, end, lt);
+  }
+
+  // g_sort: not stable (natural_merge and counting are, the others are not)
+
+  template < class IterType , class Comparator >
+  SortDecision g_sort (IterType beg, IterType end, Comparator& cmp)
+  {
+    typedef typename adaptive::Keyed<IterType,Comparator>::Type Keyed;
+    SortDecision d = adaptive::Plan(beg, end, cmp, Keyed());
+    adaptive::Run(beg, end, cmp, d, Keyed());
+    return d;
+  }
+
+  template < class IterType >
+  SortDecision g_sort (IterType beg, IterType end)
+  {
+    fsu::LessThan < typename ValueTypeOf<IterType>::Type > lt;
+    return g_sort(beg, end, lt);
+  }
+
+} // namespace fsu
+
+#endif
@@ -0,0 +1,225 @@
+/*
+    gsort_key.h
+    10/19/26
+
+    sorts that move indices and keys instead of whole elements
+
+      fsu::g_argsort        (beg, end, index [, cmp])      // index only
+      fsu::g_argsort_by_key (beg, end, index, key [, cmp]) // index only, cached keys
+      fsu::g_sort_by_key    (beg, end, key [, cmp])        // sorts, cached keys
+      fsu::g_permute        (beg, end, index)              // applies an index
+
+    The comparison sorts of gsort.h move every element O(n log n) times.
+    When the elements are large records, those moves are most of the
+    memory traffic. These sorts move size_t indices, or small (key, index)
+    pairs, and touch the records only to read them, or to put each one in
+    its final place exactly once.
+
+    index is an array of end - beg size_t. On return from the argsorts,
+    beg[index[0]], beg[index[1]], ... is the range in sorted order. The
+    range itself is not changed.
+
+    key is a function object applied to an element, returning its sort key
+    (something small: a number, a pointer, a short string). It is called
+    once per element, and the keys are sorted with the elements' indices,
+    so cmp sees keys only and nothing is recomputed. Integer and float keys
+    of up to 32 bits in default order are packed with their index into one
+    64-bit word and radix sorted (rsort.h), with no comparisons at all.
+
+    g_permute puts beg[index[i]] at beg + i for all i, following the cycles
+    of the permutation: each element is moved once, plus one move through a
+    temporary per cycle. It uses index as scratch and leaves it the
+    identity.
+
+    All of these are stable: elements with equal keys keep their order.
+*/
+
+#ifndef _GSORT_KEY_H
+#define _GSORT_KEY_H
+
+#include <cstdlib>   // size_t
+#include <cstdint>
+#include <utility>   // std::move
+#include <type_traits>
+#include <compare.h> // LessThan
+#include <gsort.h>   // g_merge_sort_adaptive, g_intro_sort, ValueTypeOf
+#include <rsort.h>   // radix_sort
+
+namespace fsu
+{
+
+  namespace keysort
+  {
+
+    template < typename K >
+    struct KeyIndex
+    {
+      K      key;
+      size_t index;
+    };
+
+    // orders indices by the elements they refer to
+    template < class I , class P >
+    class IndexLess
+    {
+    public:
+      IndexLess (I beg, P& cmp) : beg_(beg), cmp_(cmp) {}
+      bool operator () (size_t i, size_t j) const { return cmp_(beg_[i], beg_[j]); }
+    private:
+      I  beg_;
+      P& cmp_;
+    };
+
+    // orders (key, index) pairs by key, then index: a strict total order,
+    // so any sort of the pairs gives the stable order of the elements
+    template < typename K , class P >
+    class KeyLess
+    {
+    public:
+      explicit KeyLess (P& cmp) : cmp_(cmp) {}
+      bool operator () (const KeyIndex<K>& a, const KeyIndex<K>& b) const
+      {
+        if (cmp_(a.key, b.key)) return 1;
+        if (cmp_(b.key, a.key)) return 0;
+        return a.index < b.index;
+      }
+    private:
+      P& cmp_;
+    };
+
+    // keys of at most 32 bits in default order: the (key, index) pairs are
+    // packed into 64-bit words, order-preserving key above index, and
+    // radix sorted, which is the same total order as KeyLess
+    template < typename K >
+    struct Packable
+    {
+      static const bool value = sizeof(K) <= 4
+                                && ((std::is_integral<K>::value && !std::is_same<K,bool>::value)
+                                    || std::is_same<K,float>::value);
+    };
+
+    template < typename K , class P >
+    void Sort (KeyIndex<K>* pairs, size_t n, P& cmp, std::false_type)
+    {
+      KeyLess < K , P > less(cmp);
+      g_intro_sort(pairs, pairs + n, less);
+    }
+
+    template < typename K >
+    void Sort (KeyIndex<K>* pairs, size_t n, fsu::LessThan<K>& cmp, std::true_type)
+    {
+      if (n > 0xFFFFFFFFull) // index does not fit in 32 bits
+      {
+        Sort(pairs, n, cmp, std::false_type());
+        return;
+      }
+      uint64_t* w = new uint64_t [n];
+      for (size_t i = 0; i < n; ++i)
+        w[i] = ((uint64_t)radix::Key<K>::Encode(pairs[i].key) << 32) | pairs[i].index;
+      radix_sort(w, n);
+      for (size_t i = 0; i < n; ++i)
+        pairs[i].index = (size_t)(w[i] & 0xFFFFFFFFull); // keys are not needed again
+      delete [] w;
+    }
+
+    template < typename K , class P >
+    struct Packed // whether Sort may pack: default order only
+    {
+      typedef std::false_type Type;
+    };
+
+    template < typename K >
+    struct Packed < K , fsu::LessThan<K> >
+    {
+      typedef std::integral_constant<bool, Packable<K>::value> Type;
+    };
+
+  } // namespace keysort
+
+  template < class RAIterator , class Comparator >
+  void g_argsort (RAIterator beg, RAIterator end, size_t* index, Comparator& cmp)
+  {
+    size_t n = end - beg;
+    for (size_t i = 0; i < n; ++i)
+      index[i] = i;
+    keysort::IndexLess < RAIterator , Comparator > less(beg, cmp);
+    g_merge_sort_adaptive(index, index + n, less);
+  }
+
+  template < class RAIterator >
+  void g_argsort (RAIterator beg, RAIterator end, size_t* index)
+  {
+    fsu::LessThan < typename ValueTypeOf<RAIterator>::Type > lt;
+    g_argsort(beg, end, index, lt);
+  }
+
+  template < class RAIterator , class KeyFunction , class Comparator >
+  void g_argsort_by_key (RAIterator beg, RAIterator end, size_t* index, KeyFunction key, Comparator& cmp)
+  {
+    typedef typename std::decay<decltype(key(*beg))>::type K;
+    size_t n = end - beg;
+    keysort::KeyIndex<K>* pairs = new keysort::KeyIndex<K> [n];
+    for (size_t i = 0; i < n; ++i)
+    {
+      pairs[i].key   = key(beg[i]);
+      pairs[i].index = i;
+    }
+    keysort::Sort(pairs, n, cmp, typename keysort::Packed<K,Comparator>::Type());
+    for (size_t i = 0; i < n; ++i)
+      index[i] = pairs[i].index;
+    delete [] pairs;
+  }
+
+  template < class RAIterator , class KeyFunction >
+  void g_argsort_by_key (RAIterator beg, RAIterator end, size_t* index, KeyFunction key)
+  {
+    fsu::LessThan < typename std::decay<decltype(key(*beg))>::type > lt;
+    g_argsort_by_key(beg, end, index, key, lt);
+  }
+
+  template < class RAIterator >
+  void g_permute (RAIterator beg, RAIterator end, size_t* index)
+  {
+    typedef typename ValueTypeOf<RAIterator>::Type T;
+    size_t n = end - beg;
+    for (size_t i = 0; i < n; ++i)
+    {
+      if (index[i] == i)
+        continue;
+      // the cycle through i: beg[i] is moved out, each place is filled
+      // from the place index names, and the last is filled from the temporary
+      T t(std::move(beg[i]));
+      size_t j = i;
+      while (index[j] != i)
+      {
+        size_t k = index[j];
+        beg[j] = std::move(beg[k]);
+        index[j] = j;
+        j = k;
+      }
+      beg[j] = std::move(t);
+      index[j] = j;
+    }
+  }
+
+  template < class RAIterator , class KeyFunction , class Comparator >
+  void g_sort_by_key (RAIterator beg, RAIterator end, KeyFunction key, Comparator& cmp)
+  {
+    size_t n = end - beg;
+    if (n < 2) return;
+    size_t* index = new size_t [n];
+    g_argsort_by_key(beg, end, index, key, cmp);
+    g_permute(beg, end, index);
+    delete [] index;
+  }
+
+  template < class RAIterator , class KeyFunction >
+  void g_sort_by_key (RAIterator beg, RAIterator end, KeyFunction key)
+  {
+    fsu::LessThan < typename std::decay<decltype(key(*beg))>::type > lt;
+    g_sort_by_key(beg, end, key, lt);
+  }
+
+} // namespace fsu
+
+#endif
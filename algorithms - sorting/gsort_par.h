@@ -0,0 +1,297 @@
+/*
+    gsort_par.h
+    10/19/26
+
+    parallel versions of the generic sort algorithms in gsort.h
+
+      g_parallel_merge_sort
+      g_parallel_quick_sort
+      g_parallel_quick_sort_3w
+
+    Work is forked onto a TaskPool (tpool.h) down to policy.grain elements
+    (gsort_policy.h), below which the sequential algorithms of gsort.h take
+    over.
+
+    The comparator is shared by all threads, so it must be safe to call
+    concurrently. fsu::LessThan is, and so is fsu::Instrumented
+    (ginstrument.h), whose counters are thread local; the counting "spy"
+    predicates are not.
+*/
+
+#ifndef _GSORT_PAR_H
+#define _GSORT_PAR_H
+
+#include <cstdlib>   // size_t
+#include <compare.h> // LessThan
+#include <gheap.h>   // g_heap_sort, g_XC
+#include <gsort.h>
+#include <gsort_policy.h>
+#include <tpool.h>
+
+namespace fsu
+{
+
+  namespace parsort
+  {
+
+    // merge path: of the first d elements of the stable merge of a[0,na)
+    // and b[0,nb), returns how many come from a. Ties go to a.
+    template < class I , class J , class P >
+    size_t MergePath (I a, size_t na, J b, size_t nb, size_t d, P& cmp)
+    {
+      size_t lo = (d > nb) ? d - nb : 0;
+      size_t hi = (d < na) ? d : na;
+      while (lo < hi)
+      {
+        size_t i = (lo + hi) >> 1;
+        if (cmp(b[d - i - 1], a[i])) // a[i] falls after the first d
+          hi = i;
+        else
+          lo = i + 1;
+      }
+      return lo;
+    }
+
+    // merges a[0,h) and a[h,n) into b[0,n), cutting the output into
+    // independent pieces along the merge path
+    template < class I , class J , class P >
+    void Merge (I a, J b, size_t h, size_t n, size_t grain, P& cmp, TaskPool& pool)
+    {
+      size_t parts = n / grain;
+      if (parts > 8 * pool.Size())
+        parts = 8 * pool.Size();
+      if (parts < 2)
+      {
+        mergesort::Merge(a, a + h, a + h, a + n, b, cmp);
+        return;
+      }
+      TaskGroup group(pool);
+      size_t d0 = 0, i0 = 0;
+      for (size_t k = 1; k <= parts; ++k)
+      {
+        size_t d1 = (k == parts) ? n : (n / parts) * k;
+        size_t i1 = MergePath(a, h, a + h, n - h, d1, cmp);
+        I l0 = a + i0, l1 = a + i1, r0 = a + (h + d0 - i0), r1 = a + (h + d1 - i1);
+        J out = b + d0;
+        group.Spawn([l0, l1, r0, r1, out, &cmp]() { mergesort::Merge(l0, l1, r0, r1, out, cmp); });
+        d0 = d1; i0 = i1;
+      }
+      group.Wait();
+    }
+
+    // Pre:  a[0,n) holds the elements
+    // Post: they are in order in b[0,n) if into, in a[0,n) otherwise
+    //       (as mergesort::SortOpt)
+    template < class I , class J , class P , class A >
+    void Sort (I a, J b, size_t n, bool into, P& cmp, TaskPool& pool, const SortPolicy<A>& policy)
+    {
+      if (n <= policy.grain)
+      {
+        mergesort::SortOpt(a, b, n, into, policy.cutoff, cmp);
+        return;
+      }
+      instrument::Level < P > level;
+      size_t h = n >> 1;
+      {
+        TaskGroup group(pool);
+        group.Spawn([a, b, h, into, &cmp, &pool, &policy]() { Sort(a, b, h, !into, cmp, pool, policy); });
+        Sort(a + h, b + h, n - h, !into, cmp, pool, policy);
+        group.Wait();
+      }
+      if (into)
+        Merge(a, b, h, n, policy.grain, cmp, pool);
+      else
+        Merge(b, a, h, n, policy.grain, cmp, pool);
+    }
+
+    // parallel quicksort: each partition step above the grain leaves the
+    // smaller side on the worker's deque, where an idle worker can steal it,
+    // and carries on with the larger side. Pivots and the depth limit are
+    // those of introsort, so no input drives it quadratic.
+    template < class I , class P , class A >
+    void QuickSort (I beg, I end, size_t depth, P& cmp, TaskGroup& group, const SortPolicy<A>& policy)
+    {
+      instrument::Level < P > level;
+      while ((size_t)(end - beg) > policy.grain)
+      {
+        if (depth == 0)
+        {
+          g_heap_sort(beg, end, cmp);
+          return;
+        }
+        --depth;
+        quicksort::SelectPivot(beg, end - 1, policy.pivot, cmp);
+        I q = quicksort::Partition(beg, end - 1, cmp);
+        instrument::Partition(cmp, q - beg, end - q - 1);
+        I l = beg, r = q; // smaller side, handed off
+        if (q - beg < end - q)
+          beg = q + 1;
+        else
+        {
+          l = q + 1; r = end;
+          end = q;
+        }
+        if ((size_t)(r - l) > policy.grain)
+          group.Spawn([l, r, depth, &cmp, &group, &policy]() { QuickSort(l, r, depth, cmp, group, policy); });
+        else
+          introsort::Sort(l, r, depth, cmp, policy);
+      }
+      introsort::Sort(beg, end, depth, cmp, policy);
+    }
+
+    // 3-way quicksort in the same style: elements equal to the pivot are
+    // finished in the partition step that finds them, so duplicate-heavy
+    // data shrinks fast at every level, parallel or not
+    template < class I , class P , class A >
+    void QuickSort3w (I beg, I end, size_t depth, P& cmp, TaskGroup& group, const SortPolicy<A>& policy)
+    {
+      instrument::Level < P > level;
+      while ((size_t)(end - beg) > policy.cutoff && end - beg > 1)
+      {
+        if (depth == 0)
+        {
+          g_heap_sort(beg, end, cmp);
+          return;
+        }
+        --depth;
+        quicksort::SelectPivot(beg, end - 1, policy.pivot, cmp);
+        I low, hih;
+        quicksort::Partition3w(beg, end - 1, low, hih, cmp);
+        instrument::Partition(cmp, low - beg, end - hih);
+        // [beg,low) < v, [low,hih) == v, [hih,end) > v
+        I l = beg, r = low; // smaller side
+        if (low - beg < end - hih)
+          beg = hih;
+        else
+        {
+          l = hih; r = end;
+          end = low;
+        }
+        if ((size_t)(r - l) > policy.grain)
+          group.Spawn([l, r, depth, &cmp, &group, &policy]() { QuickSort3w(l, r, depth, cmp, group, policy); });
+        else
+          QuickSort3w(l, r, depth, cmp, group, policy);
+      }
+      if (end - beg > 1)
+        snet::LeafSort(beg, end, cmp);
+    }
+
+  } // namespace parsort
+
+  // parallel merge sort: stable, Theta(n log n) work, one n-element buffer
+  // (see MergeBuffer in gsort.h); the halves are forked onto the pool and
+  // each merge above policy.grain elements is split by merge path
+
+  template < class RAIterator , class T , class A , class Comparator , class B >
+  void g_parallel_merge_sort (RAIterator beg, RAIterator end, MergeBuffer<T,A>& buffer, Comparator& cmp,
+                              TaskPool& pool, const SortPolicy<B>& policy)
+  {
+    size_t size = end - beg;
+    if (size < 2) return;
+    SortPolicy<B> p(policy);
+    if (p.grain < 2) p.grain = 2;
+    buffer.Reserve(size);
+    parsort::Sort(beg, buffer.Data(), size, 0, cmp, pool, p);
+  }
+
+  template < class RAIterator , class Comparator , class A >
+  void g_parallel_merge_sort (RAIterator beg, RAIterator end, Comparator& cmp, const SortPolicy<A>& policy)
+  {
+    MergeBuffer < typename ValueTypeOf<RAIterator>::Type , A > buffer;
+    g_parallel_merge_sort(beg, end, buffer, cmp, TaskPool::Default(), policy);
+  }
+
+  template < class RAIterator , class T , class A , class Comparator >
+  void g_parallel_merge_sort (RAIterator beg, RAIterator end, MergeBuffer<T,A>& buffer, Comparator& cmp)
+  {
+    SortPolicy<A> policy(TunedPolicy<T>::Merge(end - beg));
+    g_parallel_merge_sort(beg, end, buffer, cmp, TaskPool::Default(), policy);
+  }
+
+  template < class RAIterator , class T , class A >
+  void g_parallel_merge_sort (RAIterator beg, RAIterator end, MergeBuffer<T,A>& buffer)
+  {
+    fsu::LessThan < typename ValueTypeOf<RAIterator>::Type > lt;
+    g_parallel_merge_sort(beg, end, buffer, lt);
+  }
+
+  template < class RAIterator , class Comparator >
+  void g_parallel_merge_sort (RAIterator beg, RAIterator end, Comparator& cmp)
+  {
+    MergeBuffer < typename ValueTypeOf<RAIterator>::Type > buffer;
+    g_parallel_merge_sort(beg, end, buffer, cmp);
+  }
+
+  template < class RAIterator >
+  void g_parallel_merge_sort (RAIterator beg, RAIterator end)
+  {
+    MergeBuffer < typename ValueTypeOf<RAIterator>::Type > buffer;
+    g_parallel_merge_sort(beg, end, buffer);
+  }
+
+  // parallel quicksort (2-way and 3-way): not stable, Theta(n log n) work
+  // worst case, no extra space beyond the task deques
+
+  template < class IterType , class Comparator , class A >
+  void g_parallel_quick_sort (IterType beg, IterType end, Comparator& cmp,
+                              TaskPool& pool, const SortPolicy<A>& policy)
+  {
+    if (end - beg < 2) return;
+    TaskGroup group(pool);
+    parsort::QuickSort(beg, end, introsort::DepthLimit(end - beg), cmp, group, policy);
+    group.Wait();
+  }
+
+  template < class IterType , class Comparator , class A >
+  void g_parallel_quick_sort (IterType beg, IterType end, Comparator& cmp, const SortPolicy<A>& policy)
+  {
+    g_parallel_quick_sort(beg, end, cmp, TaskPool::Default(), policy);
+  }
+
+  template < class IterType , class Comparator >
+  void g_parallel_quick_sort (IterType beg, IterType end, Comparator& cmp)
+  {
+    SortPolicy<> policy = TunedPolicy < typename ValueTypeOf<IterType>::Type >::Quick(end - beg);
+    g_parallel_quick_sort(beg, end, cmp, policy);
+  }
+
+  template < class IterType >
+  void g_parallel_quick_sort (IterType beg, IterType end)
+  {
+    fsu::LessThan < typename ValueTypeOf<IterType>::Type > lt;
+    g_parallel_quick_sort(beg, end, lt);
+  }
+
+  template < class IterType , class Comparator , class A >
+  void g_parallel_quick_sort_3w (IterType beg, IterType end, Comparator& cmp,
+                                 TaskPool& pool, const SortPolicy<A>& policy)
+  {
+    if (end - beg < 2) return;
+    TaskGroup group(pool);
+    parsort::QuickSort3w(beg, end, introsort::DepthLimit(end - beg), cmp, group, policy);
+    group.Wait();
+  }
+
+  template < class IterType , class Comparator , class A >
+  void g_parallel_quick_sort_3w (IterType beg, IterType end, Comparator& cmp, const SortPolicy<A>& policy)
+  {
+    g_parallel_quick_sort_3w(beg, end, cmp, TaskPool::Default(), policy);
+  }
+
+  template < class IterType , class Comparator >
+  void g_parallel_quick_sort_3w (IterType beg, IterType end, Comparator& cmp)
+  {
+    SortPolicy<> policy = TunedPolicy < typename ValueTypeOf<IterType>::Type >::Quick(end - beg);
+    g_parallel_quick_sort_3w(beg, end, cmp, policy);
+  }
+
+  template < class IterType >
+  void g_parallel_quick_sort_3w (IterType beg, IterType end)
+  {
+    fsu::LessThan < typename ValueTypeOf<IterType>::Type > lt;
+    g_parallel_quick_sort_3w(beg, end, lt);
+  }
+
+} // namespace fsu
+
+#endif
@@ -0,0 +1,123 @@
+/*
+    gsort_policy.h
+    10/19/26
+
+    per-call tuning for the optimized, intro and parallel sorts
+
+      SortPolicy<A>  - leaf cutoff, pivot rule, parallel grain, scratch allocator
+      PivotRule      - how quicksort picks its pivot
+      NewAllocator   - default scratch allocator (new[] / delete[])
+
+    A policy is passed by const reference and only read, so any number of
+    sorts may run at once, on any threads, each with its own tuning:
+
+      fsu::SortPolicy<> policy;  // compile-time defaults
+      policy.cutoff = 24;
+      fsu::g_intro_sort(beg, end, cmp, policy);
+
+    The sorts that are called without a policy build one from the
+    compile-time defaults below, which may be overridden with -D on the
+    command line:
+
+      GSORT_MERGE_CUTOFF    g_merge_sort_opt, g_parallel_merge_sort
+      GSORT_INTRO_CUTOFF    g_intro_sort, g_quick_sort_opt, g_quick_sort_3w_opt,
+                            g_nth_element, g_parallel_quick_sort,
+                            g_parallel_quick_sort_3w (also the SortPolicy default)
+      GSORT_PIVOT           all of them
+      GSORT_GRAIN           the parallel sorts
+
+    An allocator is a class with static members
+
+      template < typename T > T*   Allocate   (size_t n);
+      template < typename T > void Deallocate (T* p);
+
+    Host tuning: "sortspy.x autotune gsort_tune.h" times the sorts on the
+    machine it runs on and writes the best cutoff, pivot rule and grain for
+    each element type and size class to gsort_tune.h, as specializations of
+    TunedPolicy. Compiling with -DGSORT_TUNED (make TUNE=-DGSORT_TUNED) makes
+    all of the sorts above use them whenever they are called without a
+    policy: TunedPolicy<T>::Quick for the quicksorts and g_nth_element,
+    TunedPolicy<T>::Merge for the merge sorts.
+*/
+
+#ifndef _GSORT_POLICY_H
+#define _GSORT_POLICY_H
+
+#include <cstdlib>   // size_t
+
+#ifndef GSORT_MERGE_CUTOFF
+#define GSORT_MERGE_CUTOFF   8
+#endif
+
+#ifndef GSORT_INTRO_CUTOFF
+#define GSORT_INTRO_CUTOFF   16
+#endif
+
+#ifndef GSORT_PIVOT
+#define GSORT_PIVOT          pivot_ninther
+#endif
+
+#ifndef GSORT_GRAIN
+#define GSORT_GRAIN          16384
+#endif
+
+namespace fsu
+{
+
+  enum PivotRule
+  {
+    pivot_last,    // the last element of the range, as in the classic quicksort
+    pivot_median3, // median of the first, middle and last elements
+    pivot_ninther  // median3, or Tukey's ninther for long ranges
+  };
+
+  struct NewAllocator
+  {
+    template < typename T >
+    static T* Allocate (size_t n) { return new T [n]; }
+
+    template < typename T >
+    static void Deallocate (T* p) { delete [] p; }
+  };
+
+  template < class A = NewAllocator >
+  struct SortPolicy
+  {
+    typedef A Allocator;
+
+    size_t    cutoff; // ranges this short are finished by snet::LeafSort
+    PivotRule pivot;
+    size_t    grain;  // ranges this short are sorted by one thread
+
+    explicit SortPolicy (size_t c = GSORT_INTRO_CUTOFF, PivotRule p = GSORT_PIVOT, size_t g = GSORT_GRAIN)
+      : cutoff(c), pivot(p), grain(g)
+    {}
+
+    template < class B > // same tuning, another allocator
+    explicit SortPolicy (const SortPolicy<B>& p)
+      : cutoff(p.cutoff), pivot(p.pivot), grain(p.grain)
+    {}
+  };
+
+  // size classes for tuned policies: small n < tune_small <= medium n < tune_medium <= large n
+  const size_t tune_small  = 4096;
+  const size_t tune_medium = 1048576;
+
+  // TunedPolicy<T>: policies for sorting n elements of type T, the
+  // compile-time defaults unless gsort_tune.h specializes it for T
+  template < typename T >
+  struct TunedPolicy
+  {
+    // the quicksorts and g_nth_element
+    static SortPolicy<> Quick (size_t) { return SortPolicy<>(GSORT_INTRO_CUTOFF, GSORT_PIVOT, GSORT_GRAIN); }
+    // g_merge_sort_opt, g_parallel_merge_sort
+    static SortPolicy<> Merge (size_t) { return SortPolicy<>(GSORT_MERGE_CUTOFF, GSORT_PIVOT, GSORT_GRAIN); }
+  };
+
+} // namespace fsu
+
+#ifdef GSORT_TUNED
+#include <gsort_tune.h>
+#endif
+
+#endif
@@ -23,8 +23,7 @@
     Copyright 2015, R. C. Lacher
 */
 
-#include <genalg.h> // Swap, g_copy
-#include <gset.h>   // g_set_merge
+#include <utility>  // std::move, std::swap
 
 namespace fsu
 {
@@ -39,7 +38,7 @@ namespace fsu
       for (j = i; j != end; ++j)
         if (*j < *k)
           k = j;
-      Swap (*i, *k);
+      std::swap (*i, *k);
     }
   }
 
@@ -53,13 +52,12 @@ namespace fsu
   void g_insertion_sort (BidirectionalIterator beg, BidirectionalIterator end)
   {
     BidirectionalIterator i, j, k;
-    typename BidirectionalIterator::ValueType t;
     for (i = beg; i != end; ++i)
     {
-      t = *i;
+      typename BidirectionalIterator::ValueType t(std::move(*i));
       for (k = i, j = k--; j != beg && t < *k; --j, --k)
-        *j = *k;
-      *j = t;
+        *j = std::move(*k);
+      *j = std::move(t);
     }
   }
 
@@ -67,13 +65,12 @@ namespace fsu
   void g_insertion_sort (BidirectionalIterator beg, BidirectionalIterator end, Comparator& cmp)
   {
     BidirectionalIterator i, j, k;
-    typename BidirectionalIterator::ValueType t;
     for (i = beg; i != end; ++i)
     {
-      t = *i;
+      typename BidirectionalIterator::ValueType t(std::move(*i));
       for (k = i, j = k--; j != beg && cmp(t,*k); --j, --k)
-        *j = *k;
-      *j = t;
+        *j = std::move(*k);
+      *j = std::move(t);
     }
   }
 
@@ -83,13 +80,12 @@ namespace fsu
   {
     // fsu::Debug ("g_insertion_sort");
     T *i, *j, *k;
-    T t;
     for (i = beg; i != end; ++i)
     {
-      t = *i;
+      T t(std::move(*i));
       for (k = i, j = k--; j != beg && t < *k; --j, --k)
-        *j = *k;
-      *j = t;
+        *j = std::move(*k);
+      *j = std::move(t);
     }
   }
 
@@ -98,13 +94,12 @@ namespace fsu
   void g_insertion_sort (T* beg, T* end, Comparator& cmp)
   {
     T *i, *j, *k;
-    T t;
     for (i = beg; i != end; ++i)
     {
-      t = *i;
+      T t(std::move(*i));
       for (k = i, j = k--; j != beg && cmp(t,*k); --j, --k)
-        *j = *k;
-      *j = t;
+        *j = std::move(*k);
+      *j = std::move(t);
     }
   }
 
@@ -115,13 +110,40 @@ namespace fsu
     // these are the special "merge" functions supporting merge sort
     // note that these are complete and can be used as is
 
+    // stable merge of sorted [a,ae) and [b,be) into dest, moving the
+    // elements (types that cannot be moved are copied)
+    template < class I , class J , class P >
+    void MoveMerge (I a, I ae, I b, I be, J dest, P& cmp)
+    {
+      for ( ; a != ae && b != be; ++dest)
+      {
+        if (cmp(*b, *a)) { *dest = std::move(*b); ++b; }
+        else             { *dest = std::move(*a); ++a; }
+      }
+      for ( ; a != ae; ++a, ++dest) *dest = std::move(*a);
+      for ( ; b != be; ++b, ++dest) *dest = std::move(*b);
+    }
+
+    template < class I , class J >
+    void MoveBack (I beg, I end, J dest)
+    {
+      for ( ; beg != end; ++beg, ++dest) *dest = std::move(*beg);
+    }
+
+    template < typename T >
+    struct Less
+    {
+      bool operator () (const T& a, const T& b) const { return a < b; }
+    };
+
     // for random access iterators and default order
     template < typename RAIterator >
     void Merge(RAIterator beg, RAIterator mid, RAIterator end)
     {
       typename RAIterator::ValueType  B [end - beg];   // temp space for merged copy of A
-      g_set_merge(beg, mid, mid, end, B);      // merge the two parts of A to B
-      g_copy(B, B+(end-beg), beg);             // copy B back to A[p,r)
+      Less < typename RAIterator::ValueType > lt;
+      MoveMerge(beg, mid, mid, end, B, lt);    // merge the two parts of A to B
+      MoveBack(B, B+(end-beg), beg);           // move B back to A[p,r)
     }
 
     // for random access iterators and order determined by a predicate object
@@ -129,8 +151,8 @@ namespace fsu
     void Merge(RAIterator beg, RAIterator mid, RAIterator end, Comparator& cmp)
     {
       typename RAIterator::ValueType  B [end - beg];
-      g_set_merge(beg, mid, mid, end, B, cmp);
-      g_copy(B, B+(end-beg), beg);
+      MoveMerge(beg, mid, mid, end, B, cmp);
+      MoveBack(B, B+(end-beg), beg);
     }
 
     // specialization for pointers and default order
@@ -138,8 +160,9 @@ namespace fsu
     void Merge(T* beg, T* mid, T* end)
     {
       T B [end - beg];                     // temp space for merged copy of A
-      g_set_merge(beg, mid, mid, end, B);  // merge the two parts of A to B
-      g_copy(B, B+(end-beg), beg);         // copy B back to A[p,r)
+      Less < T > lt;
+      MoveMerge(beg, mid, mid, end, B, lt); // merge the two parts of A to B
+      MoveBack(B, B+(end-beg), beg);       // move B back to A[p,r)
     }
 
     // specialization for pointers and predicate order
@@ -147,8 +170,8 @@ namespace fsu
     void Merge(T* beg, T* mid, T* end, Comparator& cmp)
     {
       T B [end - beg];
-      g_set_merge(beg, mid, mid, end, B, cmp);
-      g_copy(B, B+(end-beg), beg);
+      MoveMerge(beg, mid, mid, end, B, cmp);
+      MoveBack(B, B+(end-beg), beg);
     }
 
   } // namespace mergesort
@@ -185,11 +208,11 @@ namespace fsu
       {
         if (!(*last < *j)) // if (*j <= *last)
         {
-          Swap(*pivot,*j);
+          std::swap(*pivot,*j);
           ++pivot;
         }
       }
-      Swap (*pivot,*last);
+      std::swap (*pivot,*last);
       return pivot;
     }
 
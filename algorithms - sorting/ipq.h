@@ -0,0 +1,306 @@
+/*
+    ipq.h
+    10/19/26
+
+    an indexed priority queue: a d-ary heap of handles
+
+      fsu::IndexedPriorityQueue < double , fsu::GreaterThan<double> > q; // least first
+      size_t h = q.Push(7.5);   // the entry's handle
+      q.Update(h, 2.0);         // reprioritized in O(log n)
+      q.Top(); q.TopHandle(); q.Pop();
+
+    Push returns a handle, which names the entry until it is popped or
+    erased; after that the handle is reused. A position map from handle to
+    heap slot is kept up to date on every move in the heap, so the entry of
+    a handle is found in O(1), and Update, IncreaseKey, DecreaseKey and
+    Erase take O(log n) instead of a search and a g_build_heap.
+
+    The order is that of gheap.h: P is "less than", and Top is the largest
+    by P. IncreaseKey moves an entry toward the top and DecreaseKey away
+    from it, both by P. With GreaterThan, least first as for Dijkstra or a
+    timer queue, a shorter distance or an earlier deadline is an
+    IncreaseKey. Update goes whichever way the new value needs. A call that
+    goes the wrong way would leave the heap out of order with no sign, so
+    IncreaseKey and DecreaseKey assert their preconditions (unless NDEBUG).
+
+    The heap has D children per node (see d-ary heaps in gheap.h) and holds
+    handles, not entries, so an entry never moves once pushed. Handles are
+    moved along a hole as in g_push_heap_dary and g_heap_repair_dary, and
+    each one placed has its slot set in the map.
+*/
+
+#ifndef _IPQ_H
+#define _IPQ_H
+
+#include <cstdlib>   // size_t
+#include <cassert>
+#include <vector>
+#include <iostream>
+#include <iomanip>
+#include <compare.h>
+#include <gheap.h>
+
+namespace fsu
+{
+
+  template < typename T , class P = LessThan<T> , size_t D = 4 >
+  class IndexedPriorityQueue
+  {
+  public:
+    typedef size_t Handle;
+
+    explicit IndexedPriorityQueue (const P& pred = P()) : pred_(pred) {}
+
+    Handle   Push        (const T& t);
+    void     Pop         ();                     // Pre: !Empty()
+    const T& Top         () const;               // Pre: !Empty()
+    Handle   TopHandle   () const;               // Pre: !Empty()
+
+    void     Update      (Handle h, const T& t); // Pre: Contains(h)
+    void     IncreaseKey (Handle h, const T& t); // Pre: Contains(h), !pred(t, (*this)[h])
+    void     DecreaseKey (Handle h, const T& t); // Pre: Contains(h), !pred((*this)[h], t)
+    void     Erase       (Handle h);             // Pre: Contains(h)
+
+    bool     Contains    (Handle h) const;
+    const T& operator [] (Handle h) const;       // Pre: Contains(h)
+
+    size_t   Size        () const { return heap_.size(); }
+    bool     Empty       () const { return heap_.empty(); }
+    void     Clear       ();
+    void     Reserve     (size_t n);
+
+    void     Display     (std::ostream& os, char ofc = '\0') const; // entries in heap order
+    void     Dump        (std::ostream& os) const;                  // slot, handle, entry
+    bool     Check       () const;                                  // POT and map consistent
+
+  private:
+    static_assert(D >= 2, "a heap needs at least 2 children per node");
+
+    static const size_t none = (size_t)-1; // the slot of a handle not in use
+
+    // the order of handles, by their entries
+    class HandleLess
+    {
+    public:
+      explicit HandleLess (const IndexedPriorityQueue& q) : q_(q) {}
+      bool operator () (Handle a, Handle b) const { return q_.pred_(q_.value_[a], q_.value_[b]); }
+    private:
+      const IndexedPriorityQueue& q_;
+    };
+
+    void Place    (size_t i, Handle h) { heap_[i] = h; slot_[h] = i; }
+    void SiftUp   (size_t i);
+    void SiftDown (size_t i);
+    void Fix      (size_t i); // up or down, whichever is needed
+
+    std::vector<T>      value_;  // entries, by handle
+    std::vector<size_t> slot_;   // place in heap_, by handle; none if not in use
+    std::vector<Handle> heap_;   // a D-ary POT of handles
+    std::vector<Handle> free_;   // handles to reuse
+    mutable P           pred_;
+  };
+
+  //-------------------------------------
+  // IndexedPriorityQueue <T,P,D>
+  //-------------------------------------
+
+  template < typename T , class P , size_t D >
+  const size_t IndexedPriorityQueue<T,P,D>::none;
+
+  template < typename T , class P , size_t D >
+  typename IndexedPriorityQueue<T,P,D>::Handle IndexedPriorityQueue<T,P,D>::Push (const T& t)
+  {
+    Handle h;
+    if (!free_.empty())
+    {
+      h = free_.back();
+      free_.pop_back();
+      value_[h] = t;
+    }
+    else
+    {
+      h = value_.size();
+      value_.push_back(t);
+      slot_.push_back(none);
+    }
+    heap_.push_back(h);
+    slot_[h] = heap_.size() - 1;
+    SiftUp(heap_.size() - 1);
+    return h;
+  }
+
+  template < typename T , class P , size_t D >
+  void IndexedPriorityQueue<T,P,D>::Pop ()
+  {
+    Erase(heap_[0]);
+  }
+
+  template < typename T , class P , size_t D >
+  const T& IndexedPriorityQueue<T,P,D>::Top () const
+  {
+    return value_[heap_[0]];
+  }
+
+  template < typename T , class P , size_t D >
+  typename IndexedPriorityQueue<T,P,D>::Handle IndexedPriorityQueue<T,P,D>::TopHandle () const
+  {
+    return heap_[0];
+  }
+
+  template < typename T , class P , size_t D >
+  void IndexedPriorityQueue<T,P,D>::Update (Handle h, const T& t)
+  {
+    value_[h] = t;
+    Fix(slot_[h]);
+  }
+
+  template < typename T , class P , size_t D >
+  void IndexedPriorityQueue<T,P,D>::IncreaseKey (Handle h, const T& t)
+  {
+    assert(Contains(h) && !pred_(t, value_[h])); // else DecreaseKey, or Update
+    value_[h] = t;
+    SiftUp(slot_[h]);
+  }
+
+  template < typename T , class P , size_t D >
+  void IndexedPriorityQueue<T,P,D>::DecreaseKey (Handle h, const T& t)
+  {
+    assert(Contains(h) && !pred_(value_[h], t)); // else IncreaseKey, or Update
+    value_[h] = t;
+    SiftDown(slot_[h]);
+  }
+
+  template < typename T , class P , size_t D >
+  void IndexedPriorityQueue<T,P,D>::Erase (Handle h)
+  {
+    size_t i = slot_[h];
+    Handle last = heap_.back();
+    heap_.pop_back();
+    slot_[h] = none;
+    free_.push_back(h);
+    if (i < heap_.size()) // the last handle fills the hole
+    {
+      Place(i, last);
+      Fix(i);
+    }
+  }
+
+  template < typename T , class P , size_t D >
+  bool IndexedPriorityQueue<T,P,D>::Contains (Handle h) const
+  {
+    return h < slot_.size() && slot_[h] != none;
+  }
+
+  template < typename T , class P , size_t D >
+  const T& IndexedPriorityQueue<T,P,D>::operator [] (Handle h) const
+  {
+    return value_[h];
+  }
+
+  template < typename T , class P , size_t D >
+  void IndexedPriorityQueue<T,P,D>::Clear ()
+  {
+    value_.clear();
+    slot_.clear();
+    heap_.clear();
+    free_.clear();
+  }
+
+  template < typename T , class P , size_t D >
+  void IndexedPriorityQueue<T,P,D>::Reserve (size_t n)
+  {
+    value_.reserve(n);
+    slot_.reserve(n);
+    heap_.reserve(n);
+  }
+
+  template < typename T , class P , size_t D >
+  void IndexedPriorityQueue<T,P,D>::SiftUp (size_t i)
+  // as g_push_heap_dary, from slot i
+  {
+    Handle h = heap_[i];
+    while (i > 0)
+    {
+      size_t p = (i - 1) / D;
+      if (!pred_(value_[heap_[p]], value_[h]))
+        break;
+      Place(i, heap_[p]);
+      i = p;
+    }
+    Place(i, h);
+  }
+
+  template < typename T , class P , size_t D >
+  void IndexedPriorityQueue<T,P,D>::SiftDown (size_t i)
+  // as g_heap_repair_dary, from slot i
+  {
+    HandleLess less(*this);
+    size_t n = heap_.size();
+    Handle h = heap_[i];
+    size_t c = D * i + 1;
+    for ( ; c + D <= n; c = D * i + 1) // a full group of children
+    {
+      size_t m = dary::LargestChild<D>(heap_.begin(), c, less);
+      if (!less(h, heap_[m]))
+      {
+        c = n;
+        break;
+      }
+      Place(i, heap_[m]);
+      i = m;
+    }
+    if (c < n) // the last parent's group, short
+    {
+      size_t m = dary::Largest(heap_.begin(), c, n, less);
+      if (less(h, heap_[m]))
+      {
+        Place(i, heap_[m]);
+        i = m;
+      }
+    }
+    Place(i, h);
+  }
+
+  template < typename T , class P , size_t D >
+  void IndexedPriorityQueue<T,P,D>::Fix (size_t i)
+  {
+    if (i > 0 && pred_(value_[heap_[(i - 1) / D]], value_[heap_[i]]))
+      SiftUp(i);
+    else
+      SiftDown(i);
+  }
+
+  template < typename T , class P , size_t D >
+  void IndexedPriorityQueue<T,P,D>::Display (std::ostream& os, char ofc) const
+  {
+    for (size_t i = 0; i < heap_.size(); ++i)
+    {
+      if (ofc != '\0' && i > 0) os << ofc;
+      os << value_[heap_[i]];
+    }
+  }
+
+  template < typename T , class P , size_t D >
+  void IndexedPriorityQueue<T,P,D>::Dump (std::ostream& os) const
+  {
+    os << "  slot  handle  entry\n";
+    for (size_t i = 0; i < heap_.size(); ++i)
+      os << std::setw(6) << i << std::setw(8) << heap_[i] << "  " << value_[heap_[i]] << '\n';
+  }
+
+  template < typename T , class P , size_t D >
+  bool IndexedPriorityQueue<T,P,D>::Check () const
+  {
+    for (size_t i = 0; i < heap_.size(); ++i)
+    {
+      if (heap_[i] >= slot_.size() || slot_[heap_[i]] != i)
+        return 0;
+      if (i > 0 && pred_(value_[heap_[(i - 1) / D]], value_[heap_[i]]))
+        return 0;
+    }
+    return heap_.size() + free_.size() == slot_.size();
+  }
+
+} // namespace fsu
+
+#endif
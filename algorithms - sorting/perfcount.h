@@ -0,0 +1,226 @@
+/*
+    perfcount.h
+    10/19/26
+
+    hardware performance counters around a region of code, on Linux through
+    perf_event_open(2)
+
+      fsu::PerfCounters perf;
+      if (!perf.Open()) std::cout << perf.Error();  // none at all: run without
+      perf.Start();
+      sort(a, a + n);
+      fsu::PerfSample s = perf.Stop();           // s[fsu::perf_cycles], s.IPC(), ...
+
+    The events are cycles, instructions, branch misses, L1 data cache read
+    misses, last level cache read misses, data TLB read misses and page
+    faults (a software event, there even where the CPU counters are not).
+    Each is opened on its own: whatever the kernel, the CPU or the virtual
+    machine will not give is left out, Available() says which are there and
+    Error() why the first missing one is missing. A sample value of -1 means
+    not counted. Open failing means no counter at all; nothing else about
+    the program needs to change.
+
+    The counters are not a group. The CPU has only so many, and a group
+    bigger than that is never scheduled; opened one by one the kernel
+    multiplexes them instead, and Stop scales each count by the time it was
+    enabled over the time it actually ran (PerfSample::scaled says it did).
+    Counting is user space only, which is what perf_event_paranoid 2 (the
+    usual default) allows, and for the calling thread only: the workers of
+    a TaskPool already exist and are not counted, so for the parallel sorts
+    the figures are the calling thread's share of the work.
+
+    Start and Stop are a few system calls each; the counts include the few
+    hundred instructions of them that fall between the enables and disables.
+*/
+
+#ifndef _PERFCOUNT_H
+#define _PERFCOUNT_H
+
+#include <cstdlib>   // size_t
+#include <cstdint>
+#include <cstring>   // memset, strerror
+#include <cerrno>
+#include <string>
+
+#if defined(__linux__)
+#include <unistd.h>  // syscall, read, close
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+namespace fsu
+{
+
+  enum PerfEvent { perf_cycles, perf_instructions, perf_branch_misses, perf_l1d_misses,
+                   perf_llc_misses, perf_dtlb_misses, perf_page_faults, perf_event_count };
+
+  struct PerfSample
+  {
+    long long value [perf_event_count]; // -1: not counted
+    bool      scaled;                   // some counter was multiplexed
+
+    PerfSample () : scaled(0) { for (size_t i = 0; i < perf_event_count; ++i) value[i] = -1; }
+
+    long long operator [] (size_t e) const { return value[e]; }
+
+    // instructions per cycle; 0 if either is missing
+    double IPC () const
+    {
+      return (value[perf_cycles] > 0 && value[perf_instructions] >= 0)
+           ? (double)value[perf_instructions] / value[perf_cycles] : 0;
+    }
+  };
+
+  namespace perfcount
+  {
+
+    const char* const event_names [] = { "cycles", "instructions", "branch_misses", "l1d_misses",
+                                         "llc_misses", "dtlb_misses", "page_faults" };
+
+#if defined(__linux__)
+    inline uint64_t CacheMiss (uint64_t cache)
+    {
+      return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    }
+
+    inline void Describe (PerfEvent e, uint32_t& type, uint64_t& config)
+    {
+      switch (e)
+      {
+        case perf_cycles:        type = PERF_TYPE_HARDWARE; config = PERF_COUNT_HW_CPU_CYCLES;   break;
+        case perf_instructions:  type = PERF_TYPE_HARDWARE; config = PERF_COUNT_HW_INSTRUCTIONS; break;
+        case perf_branch_misses: type = PERF_TYPE_HARDWARE; config = PERF_COUNT_HW_BRANCH_MISSES; break;
+        case perf_l1d_misses:    type = PERF_TYPE_HW_CACHE; config = CacheMiss(PERF_COUNT_HW_CACHE_L1D);  break;
+        case perf_llc_misses:    type = PERF_TYPE_HW_CACHE; config = CacheMiss(PERF_COUNT_HW_CACHE_LL);   break;
+        case perf_dtlb_misses:   type = PERF_TYPE_HW_CACHE; config = CacheMiss(PERF_COUNT_HW_CACHE_DTLB); break;
+        default:                 type = PERF_TYPE_SOFTWARE; config = PERF_COUNT_SW_PAGE_FAULTS;  break;
+      }
+    }
+
+    // a disabled counter of e for the calling thread, or -1 with errno set
+    inline int OpenEvent (PerfEvent e)
+    {
+      perf_event_attr attr;
+      std::memset(&attr, 0, sizeof(attr));
+      uint32_t type;
+      uint64_t config;
+      Describe(e, type, config);
+      attr.size           = sizeof(attr);
+      attr.type           = type;
+      attr.config         = config;
+      attr.disabled       = 1;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv     = 1;
+      attr.read_format    = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+      return (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+#endif
+
+  } // namespace perfcount
+
+  class PerfCounters
+  {
+  public:
+    PerfCounters () { for (size_t i = 0; i < perf_event_count; ++i) fd_[i] = -1; }
+    ~PerfCounters () { Close(); }
+
+    // opens every event it can; false if it could open none
+    bool Open ()
+    {
+      Close();
+      error_.clear();
+#if defined(__linux__)
+      for (size_t i = 0; i < perf_event_count; ++i)
+      {
+        fd_[i] = perfcount::OpenEvent((PerfEvent)i);
+        if (fd_[i] < 0 && error_.empty())
+        {
+          int code = errno;
+          error_ = std::string("no ") + Name((PerfEvent)i) + ": " + std::strerror(code);
+          if (code == EACCES || code == EPERM)
+            error_ += " (see /proc/sys/kernel/perf_event_paranoid)";
+          else if (code == ENOENT || code == EOPNOTSUPP)
+            error_ += " (no such counter on this CPU, or a virtual machine without them)";
+        }
+      }
+#else
+      error_ = "performance counters are read through Linux perf_event_open only";
+#endif
+      return Any();
+    }
+
+    void Close ()
+    {
+#if defined(__linux__)
+      for (size_t i = 0; i < perf_event_count; ++i)
+        if (fd_[i] >= 0)
+        {
+          ::close(fd_[i]);
+          fd_[i] = -1;
+        }
+#endif
+    }
+
+    bool Available (PerfEvent e) const { return fd_[e] >= 0; }
+
+    bool Any () const
+    {
+      for (size_t i = 0; i < perf_event_count; ++i)
+        if (fd_[i] >= 0) return 1;
+      return 0;
+    }
+
+    // why the first missing event is missing; empty if none is
+    const std::string& Error () const { return error_; }
+
+    void Start ()
+    {
+#if defined(__linux__)
+      for (size_t i = 0; i < perf_event_count; ++i)
+        if (fd_[i] >= 0)
+        {
+          ioctl(fd_[i], PERF_EVENT_IOC_RESET, 0);
+          ioctl(fd_[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    PerfSample Stop ()
+    {
+      PerfSample s;
+#if defined(__linux__)
+      for (size_t i = 0; i < perf_event_count; ++i)
+        if (fd_[i] >= 0)
+          ioctl(fd_[i], PERF_EVENT_IOC_DISABLE, 0);
+      for (size_t i = 0; i < perf_event_count; ++i)
+      {
+        uint64_t r [3]; // value, time enabled, time running
+        if (fd_[i] < 0 || ::read(fd_[i], r, sizeof(r)) != (ssize_t)sizeof(r))
+          continue;
+        if (r[2] == 0)  // never scheduled
+          continue;
+        if (r[2] < r[1])
+        {
+          s.scaled = 1;
+          r[0] = (uint64_t)((double)r[0] * r[1] / r[2]);
+        }
+        s.value[i] = (long long)r[0];
+      }
+#endif
+      return s;
+    }
+
+    static const char* Name (PerfEvent e) { return perfcount::event_names[e]; }
+
+  private:
+    int         fd_ [perf_event_count];
+    std::string error_;
+
+    PerfCounters (const PerfCounters&);             // disallowed
+    PerfCounters& operator = (const PerfCounters&); // disallowed
+  };
+
+} // namespace fsu
+
+#endif
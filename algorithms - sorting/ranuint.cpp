@@ -3,26 +3,68 @@
     10/19/13
     Chris Lacher
 
-    creates random string data for testing 
+    creates random string data for testing
 
     Copyright 2013, R.C. Lacher
+
+    10/19/26: the data is made by datagen.h, in parallel and reproducibly
+    from a seed, in any of its shapes; "adversary" makes McIlroy's input
+    against one of the quicksorts of gsort.h.
 */
 
 #include <iostream>
-#include <fstream>
+#include <cstring>
 #include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include <binio.h>
+#include <datagen.h>
+#include <gsort.h>
+#include <tpool.h>
 
-#include <xran.h>
-#include <xran.cpp> // in lieu of makefile
+typedef uint32_t ElementType;
+
+// the sorts anti_quicksort can be aimed at
+struct QuickSort
+{
+  template < class I , class P > void operator () (I beg, I end, P& cmp) const { fsu::g_quick_sort(beg, end, cmp); }
+};
+
+struct QuickSortOpt
+{
+  template < class I , class P > void operator () (I beg, I end, P& cmp) const { fsu::g_quick_sort_opt(beg, end, cmp); }
+};
+
+struct QuickSort3w
+{
+  template < class I , class P > void operator () (I beg, I end, P& cmp) const { fsu::g_quick_sort_3w(beg, end, cmp); }
+};
+
+struct IntroSort
+{
+  template < class I , class P > void operator () (I beg, I end, P& cmp) const { fsu::g_intro_sort(beg, end, cmp); }
+};
 
 int main( int argc , char * argv[] )
 {
-  if (argc != 4)
+  if (argc < 4 || argc > 8)
   {
     std::cout << " ** required arguments:\n"
 	      << "     1: filename\n"
 	      << "     2: upper bound on size ('0' means no upper bound)\n"
 	      << "     3: count of items\n"
+	      << " ** optional arguments:\n"
+	      << "     4: \"text\" (default) - one number per line\n"
+	      << "        \"binary\" - 4-byte unsigned, with header (see binio.h)\n"
+	      << "     5: shape (default uniform):\n"
+	      << "        uniform sorted reverse nearly_sorted organ_pipe sawtooth\n"
+	      << "        few_unique zipf equal (see datagen.h), or adversary\n"
+	      << "     6: shape parameter (default 0: the shape's default)\n"
+	      << "        nearly_sorted: swaps; sawtooth: teeth; few_unique: values;\n"
+	      << "        zipf: exponent s; adversary: quick quick_opt quick3w intro\n"
+	      << "     7: seed (default 1)\n"
 	      << " ** try again\n";
     return 0;
   }
@@ -34,25 +76,74 @@ int main( int argc , char * argv[] )
   {
     upperBound = UINT_MAX;
   }
-
-  std::ofstream out1(outfile);
-  if (out1.fail())
+  fsu::NumberFormat format = fsu::format_text;
+  if (argc > 4)
   {
-    std::cout << " ** cannot open file " << outfile << '\n'
+    if (0 == strcmp(argv[4], "binary"))
+      format = fsu::format_binary;
+    else if (0 != strcmp(argv[4], "text"))
+    {
+      std::cout << " ** unknown format " << argv[4] << '\n'
+		<< " ** try again\n";
+      return 0;
+    }
+  }
+  fsu::DataSpec spec;
+  spec.bound = upperBound;
+  const char* shape = (argc > 5) ? argv[5] : "uniform";
+  bool adversary = (0 == strcmp(shape, "adversary"));
+  const char* target = (argc > 6) ? argv[6] : "quick";
+  if (!adversary && !fsu::ParseDataShape(shape, spec.shape))
+  {
+    std::cout << " ** unknown shape " << shape << '\n'
 	      << " ** try again\n";
     return 0;
   }
+  if (!adversary && argc > 6)
+  {
+    if (spec.shape == fsu::shape_zipf) spec.s = atof(argv[6]);
+    else                               spec.k = atoll(argv[6]);
+  }
+  if (argc > 7)
+    spec.seed = strtoull(argv[7], 0, 10);
 
-  fsu::Random_unsigned_int ranuint;
+  std::vector < ElementType > data(count);
+  if (!adversary)
+    fsu::generate_data(data.data(), count, spec);
+  else if (0 == strcmp(target, "quick"))     fsu::anti_quicksort(data.data(), count, QuickSort());
+  else if (0 == strcmp(target, "quick_opt")) fsu::anti_quicksort(data.data(), count, QuickSortOpt());
+  else if (0 == strcmp(target, "quick3w"))   fsu::anti_quicksort(data.data(), count, QuickSort3w());
+  else if (0 == strcmp(target, "intro"))     fsu::anti_quicksort(data.data(), count, IntroSort());
+  else
+  {
+    std::cout << " ** unknown sort " << target << '\n'
+	      << " ** try again\n";
+    return 0;
+  }
 
-  for (size_t i = 0; i < count; ++i)
+  fsu::NumberWriter < ElementType > out1;
+  if (!out1.Open(outfile, format))
   {
-    out1 << ranuint(0, upperBound) << '\n';
+    std::cout << " ** cannot open file " << outfile << '\n'
+	      << " ** try again\n";
+    return 0;
+  }
+  out1.Write(data.data(), count, &fsu::TaskPool::Default());
+  if (!out1.Close())
+  {
+    std::cout << " ** " << out1.Error() << '\n';
+    return 0;
   }
-  out1.close();
 
-  std::cout << "Results stored in file " << outfile << '\n'
-	    << "  range: " << 0 << " .. " << upperBound - 1 << '\n'
-	    << "  count: " << count << '\n';
+  std::cout << "Results stored in file " << outfile << '\n';
+  if (adversary)
+    std::cout << "  shape: adversary against " << target << '\n'
+	      << "  range: " << 0 << " .. " << (count ? count - 1 : 0) << '\n';
+  else
+    std::cout << "  shape: " << fsu::DataShapeName(spec.shape) << '\n'
+	      << "   seed: " << spec.seed << '\n'
+	      << "  range: " << 0 << " .. " << upperBound - 1 << '\n';
+  std::cout << "  count: " << count << '\n'
+	    << " format: " << (format == fsu::format_binary ? "binary" : "text") << '\n';
   return 0;
 }
@@ -0,0 +1,292 @@
+/*
+    rsort.h
+    10/19/26
+
+    parallel LSD radix sort for arrays of integers, floats and doubles
+
+      size_t passes = fsu::radix_sort (A, n);        // TaskPool::Default()
+      size_t passes = fsu::radix_sort (A, n, pool);
+
+    Sorts A[0,n) in ascending order, stably, and returns the number of
+    scatter passes made. Element types are the 1, 2, 4 and 8-byte integral
+    types, signed or unsigned, float and double.
+
+    Digits are taken from an unsigned key that orders the same way as the
+    element (radix::Key):
+
+      unsigned  the bits themselves
+      signed    the sign bit flipped, so negatives come first
+      floating  positive: the sign bit flipped; negative: all bits flipped,
+                so that larger magnitudes come first
+
+    The map is a bijection and is applied to each element as its digit is
+    read, so the array itself always holds the original values and there is
+    nothing to undo afterwards. Floating keys sort as -inf < negatives <
+    -0.0 < +0.0 < positives < +inf; NaNs go to the ends, by sign bit.
+
+    Keys are split into digits of 8 bits (1- and 2-byte keys) or 11 bits
+    (4- and 8-byte keys: 3 passes for 32 bits, 6 for 64). The array is cut
+    into one chunk per thread, and
+
+      1. each thread counts every digit of its chunk in a single read
+      2. a pass whose digit is the same in all n keys is skipped
+      3. per pass, the per-thread counts are combined by prefix sum into
+         the position where each thread writes each digit value, then
+         every thread scatters its own chunk (counting again first on all
+         but the first pass, since the chunks hold different keys by then)
+
+    The scatter goes through a software write-combining buffer: one cache
+    line of keys per digit value and thread, written out a line at a time,
+    so the 2048 output streams of an 11-bit pass do not thrash the cache
+    and TLB with single-key stores.
+
+    Threads are used from radix::grain keys per thread up, so short arrays
+    are sorted in the calling thread. Scratch space is n keys plus the
+    histograms and buffers.
+*/
+
+#ifndef _RSORT_H
+#define _RSORT_H
+
+#include <cstdlib>   // size_t
+#include <cstdint>
+#include <cstring>   // memcpy
+#include <type_traits>
+#include <tpool.h>
+
+namespace fsu
+{
+
+  namespace radix
+  {
+
+    const size_t grain    = 65536; // fewest keys per thread
+    const size_t wc_bytes = 64;    // write-combining buffer per digit value: one cache line
+
+    template < typename T , bool F = std::is_floating_point<T>::value >
+    struct Key // integral types
+    {
+      typedef typename std::make_unsigned<T>::type Bits;
+      static const Bits sign = std::is_signed<T>::value ? (Bits)((Bits)1 << (8 * sizeof(T) - 1)) : 0;
+      static Bits Encode (T x) { return (Bits)((Bits)x ^ sign); }
+    };
+
+    template < typename T >
+    struct Key < T , true > // float, double
+    {
+      typedef typename std::conditional<sizeof(T) == 4, uint32_t, uint64_t>::type Bits;
+      static const Bits sign = (Bits)1 << (8 * sizeof(T) - 1);
+      static Bits Encode (T x)
+      {
+        Bits b;
+        std::memcpy(&b, &x, sizeof(b));
+        Bits flip = (Bits)(0 - (b >> (8 * sizeof(T) - 1))) | sign; // all bits if negative
+        return b ^ flip;
+      }
+    };
+
+    template < typename T >
+    struct DigitBits
+    {
+      static const unsigned value = (sizeof(T) <= 2) ? 8 : 11;
+    };
+
+    // runs f(0) .. f(p-1), on the pool when p > 1
+    template < class F >
+    void ForEach (size_t p, TaskPool* pool, F f)
+    {
+      if (p == 1)
+      {
+        f(0);
+        return;
+      }
+      TaskGroup group(*pool);
+      for (size_t t = 0; t < p; ++t)
+        group.Spawn([&f, t]() { f(t); });
+      group.Wait();
+    }
+
+    template < typename T >
+    class Sorter
+    {
+    public:
+      static const unsigned bits   = DigitBits<T>::value;
+      static const size_t   range  = (size_t)1 << bits;               // digit values
+      static const unsigned passes = (8 * sizeof(T) + bits - 1) / bits;
+      static const size_t   line   = (wc_bytes > sizeof(T)) ? wc_bytes / sizeof(T) : 1;
+
+      Sorter (T* a, size_t n, TaskPool* pool) // pool may be 0: one thread
+        : a_(a), n_(n), pool_(pool), threads_(n / grain)
+      {
+        if (pool == 0)                    threads_ = 1;
+        else if (threads_ > pool->Size()) threads_ = pool->Size();
+        if (threads_ == 0)                threads_ = 1;
+        b_      = new T [n];
+        counts_ = new size_t [threads_ * passes * range];
+        fill_   = new size_t [threads_ * range];
+        wcRaw_  = new char [threads_ * range * line * sizeof(T) + wc_bytes];
+        size_t mis = (size_t)(uintptr_t)wcRaw_ % wc_bytes;
+        wc_     = (T*)(wcRaw_ + (mis ? wc_bytes - mis : 0));
+      }
+
+      ~Sorter ()
+      {
+        delete [] b_;
+        delete [] counts_;
+        delete [] fill_;
+        delete [] wcRaw_;
+      }
+
+      size_t Sort ()
+      {
+        Sorter& s = *this;
+        ForEach(threads_, pool_, [&s](size_t t) { s.CountAll(t); });
+
+        T* src = a_;
+        T* dst = b_;
+        size_t made = 0;
+        for (unsigned k = 0; k < passes; ++k)
+        {
+          if (Constant(k))
+            continue;
+          if (made > 0) // the chunks hold other keys now
+            ForEach(threads_, pool_, [&s, src, k](size_t t) { s.Count(t, src, k); });
+          Offsets(k);
+          ForEach(threads_, pool_, [&s, src, dst, k](size_t t) { s.Scatter(t, src, dst, k); });
+          T* x = src; src = dst; dst = x;
+          ++made;
+        }
+        if (src != a_)
+        {
+          T* a = a_;
+          ForEach(threads_, pool_, [&s, src, a](size_t t)
+          {
+            std::memcpy(a + s.Lo(t), src + s.Lo(t), (s.Hi(t) - s.Lo(t)) * sizeof(T));
+          });
+        }
+        return made;
+      }
+
+    private:
+      static size_t Digit (T x, unsigned k) { return (size_t)(Key<T>::Encode(x) >> (k * bits)) & (range - 1); }
+
+      size_t  Lo     (size_t t) const        { return (n_ / threads_) * t; }
+      size_t  Hi     (size_t t) const        { return (t + 1 == threads_) ? n_ : Lo(t + 1); }
+      size_t* Counts (size_t t, unsigned k)  { return counts_ + (t * passes + k) * range; }
+
+      // every digit of chunk t, one read
+      void CountAll (size_t t)
+      {
+        size_t* c = Counts(t, 0);
+        for (size_t i = 0; i < passes * range; ++i)
+          c[i] = 0;
+        for (size_t i = Lo(t), hi = Hi(t); i < hi; ++i)
+        {
+          T x = a_[i];
+          for (unsigned k = 0; k < passes; ++k)
+            ++c[k * range + Digit(x, k)];
+        }
+      }
+
+      // digit k of chunk t of src
+      void Count (size_t t, const T* src, unsigned k)
+      {
+        size_t* c = Counts(t, k);
+        for (size_t d = 0; d < range; ++d)
+          c[d] = 0;
+        for (size_t i = Lo(t), hi = Hi(t); i < hi; ++i)
+          ++c[Digit(src[i], k)];
+      }
+
+      // whether all n keys have the same digit k (the first read's counts are still totals)
+      bool Constant (unsigned k)
+      {
+        size_t d = Digit(a_[0], k), total = 0;
+        for (size_t t = 0; t < threads_; ++t)
+          total += Counts(t, k)[d];
+        return total == n_;
+      }
+
+      // counts -> first output position of each digit value for each thread
+      void Offsets (unsigned k)
+      {
+        size_t sum = 0;
+        for (size_t d = 0; d < range; ++d)
+          for (size_t t = 0; t < threads_; ++t)
+          {
+            size_t* c = Counts(t, k);
+            size_t count = c[d];
+            c[d] = sum;
+            sum += count;
+          }
+      }
+
+      void Scatter (size_t t, const T* src, T* dst, unsigned k)
+      {
+        size_t* next = Counts(t, k);
+        size_t* fill = fill_ + t * range;
+        T*      wc   = wc_ + t * range * line;
+        for (size_t d = 0; d < range; ++d)
+          fill[d] = 0;
+        for (size_t i = Lo(t), hi = Hi(t); i < hi; ++i)
+        {
+          T x = src[i];
+          size_t d = Digit(x, k);
+          T* w = wc + d * line;
+          w[fill[d]] = x;
+          if (++fill[d] == line)
+          {
+            std::memcpy(dst + next[d], w, line * sizeof(T));
+            next[d] += line;
+            fill[d] = 0;
+          }
+        }
+        for (size_t d = 0; d < range; ++d)
+          if (fill[d])
+            std::memcpy(dst + next[d], wc + d * line, fill[d] * sizeof(T));
+      }
+
+      Sorter (const Sorter&);             // disallowed
+      Sorter& operator = (const Sorter&); // disallowed
+
+      T*        a_;
+      T*        b_;
+      size_t    n_;
+      TaskPool* pool_;
+      size_t    threads_;
+      size_t*   counts_; // [thread][pass][digit value]
+      size_t*   fill_;   // [thread][digit value]: keys in the write-combining buffer
+      char*     wcRaw_;
+      T*        wc_;     // [thread][digit value][line], cache-line aligned
+    };
+
+  } // namespace radix
+
+  template < typename T >
+  size_t radix_sort (T* A, size_t n, TaskPool& pool)
+  {
+    static_assert((std::is_integral<T>::value && !std::is_same<T,bool>::value)
+                  || std::is_same<T,float>::value || std::is_same<T,double>::value,
+                  "radix_sort: integer, float or double keys only");
+    if (n < 2)
+      return 0;
+    radix::Sorter<T> sorter(A, n, &pool);
+    return sorter.Sort();
+  }
+
+  template < typename T >
+  size_t radix_sort (T* A, size_t n)
+  {
+    static_assert((std::is_integral<T>::value && !std::is_same<T,bool>::value)
+                  || std::is_same<T,float>::value || std::is_same<T,double>::value,
+                  "radix_sort: integer, float or double keys only");
+    if (n < 2)
+      return 0;
+    // one chunk needs no pool: do not start the default one for it
+    radix::Sorter<T> sorter(A, n, (n < 2 * radix::grain) ? 0 : &TaskPool::Default());
+    return sorter.Sort();
+  }
+
+} // namespace fsu
+
+#endif
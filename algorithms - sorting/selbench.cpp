@@ -0,0 +1,190 @@
+/*
+    selbench.cpp
+    10/19/26
+
+    time to take the first k of n, or the kth, with a full sort and with
+    the selection algorithms
+
+      selbench.x n=1000000 k=1,10,1000,100000 reps=5
+
+    There are two data sets of n 64-bit keys, the same for every run:
+    random, all distinct, and dups, the same keys mod 100, so every key
+    comes about n/100 times. Each run works on a fresh copy, and only the
+    call is timed. Every result is checked against the full sort, and WRONG
+    is printed if it differs; for nth_element, which sorts nothing, the
+    check is the kth key and the partition around it. The median of reps
+    runs is reported.
+
+      intro_sort     g_intro_sort of all n, then the first k
+      partial_sort   g_partial_sort(beg, beg + k, end)
+      nth_element    g_nth_element(beg, beg + k - 1, end): the kth only
+      nth_then_sort  g_nth_element, then g_intro_sort of the first k
+      topk_stream    TopK(k), every key pushed, then Sorted
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+
+#include <compare.h>
+#include <gheap.h>
+#include <gsort.h>
+#include <topk.h>
+#include <sortbench.h> // ParseCounts, SplitArgument, Summarize
+
+typedef uint64_t KeyType;
+typedef std::chrono::steady_clock Clock;
+
+// SplitMix64's output function, for the keys
+inline KeyType Key (uint64_t i)
+{
+  uint64_t z = (i + 1) * 0x9E3779B97F4A7C15ull;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  return z ^ (z >> 31);
+}
+
+inline double Seconds (Clock::time_point start)
+{
+  return std::chrono::duration < double > (Clock::now() - start).count();
+}
+
+// true if a[k-1] is the kth of sorted, nothing before it is greater and
+// nothing after it is less
+bool Partitioned (const std::vector < KeyType >& a, const std::vector < KeyType >& sorted, size_t k)
+{
+  KeyType nth = a[k - 1];
+  if (nth != sorted[k - 1]) return 0;
+  for (size_t i = 0; i < k - 1; ++i)
+    if (nth < a[i]) return 0;
+  for (size_t i = k; i < a.size(); ++i)
+    if (a[i] < nth) return 0;
+  return 1;
+}
+
+// seconds for one run of method m, with a check against sorted
+double Run (size_t m, const std::vector < KeyType >& data, const std::vector < KeyType >& sorted,
+            size_t k, bool& ok)
+{
+  std::vector < KeyType > a(data), v;
+  fsu::LessThan < KeyType > lt;
+  KeyType* beg = a.data();
+  KeyType* end = beg + a.size();
+  Clock::time_point start = Clock::now();
+  double seconds;
+  switch (m)
+  {
+    case 0:
+      fsu::g_intro_sort(beg, end, lt);
+      seconds = Seconds(start);
+      break;
+    case 1:
+      fsu::g_partial_sort(beg, beg + k, end, lt);
+      seconds = Seconds(start);
+      break;
+    case 2:
+      fsu::g_nth_element(beg, beg + (k - 1), end, lt);
+      seconds = Seconds(start);
+      ok = ok && Partitioned(a, sorted, k);
+      return seconds;
+    case 3:
+      fsu::g_nth_element(beg, beg + (k - 1), end, lt);
+      fsu::g_intro_sort(beg, beg + k, lt);
+      seconds = Seconds(start);
+      break;
+    default:
+    {
+      fsu::TopK < KeyType > top(k);
+      for (size_t i = 0; i < data.size(); ++i)
+        top.Push(data[i]);
+      top.Sorted(v);
+      seconds = Seconds(start);
+      ok = ok && std::equal(v.begin(), v.end(), sorted.begin()) && v.size() == k;
+      return seconds;
+    }
+  }
+  ok = ok && std::equal(a.begin(), a.begin() + k, sorted.begin());
+  return seconds;
+}
+
+const size_t c1 = 15, c2 = 7, c3 = 10, c4 = 10, c5 = 9, c6 = 7;
+const char* names [] = { "intro_sort", "partial_sort", "nth_element", "nth_then_sort", "topk_stream" };
+const size_t methods = sizeof(names) / sizeof(names[0]);
+const char* datasets [] = { "random", "dups" };
+const size_t dups = 100; // distinct keys in dups
+
+int main (int argc, char* argv[])
+{
+  std::vector < size_t > ks(1, 1);
+  ks.push_back(10); ks.push_back(1000); ks.push_back(100000);
+  size_t n = 1000000, reps = 5;
+
+  for (int i = 1; i < argc; ++i)
+  {
+    std::string name;
+    const char* value = fsu::SplitArgument(argv[i], name);
+    bool ok = (value != 0);
+    if      (!ok)                      ;
+    else if (name == "n")              ok = (n = std::strtoull(value, 0, 10)) > 0;
+    else if (name == "k")              ok = fsu::ParseCounts(value, ks);
+    else if (name == "reps")           ok = (reps = std::strtoull(value, 0, 10)) > 0;
+    else                               ok = 0;
+    if (!ok)
+    {
+      fsu::BadArgument(std::cout, argv[i], "n=1000000 k=1,10,1000,100000 reps=5");
+      return 0;
+    }
+  }
+  for (size_t i = 0; i < ks.size(); ++i)
+    if (ks[i] > n)
+    {
+      std::cout << " ** k = " << ks[i] << " is more than n = " << n << '\n'
+                << " ** try again\n";
+      return 0;
+    }
+
+  std::cout << "\n Selection: first k of " << n << " keys, median of " << reps << " runs\n\n"
+            << ' ' << std::left << std::setw(c1) << "method" << std::setw(c2) << "data" << std::right
+            << std::setw(c3) << "k"
+            << std::setw(c4) << "msec"
+            << std::setw(c5) << "speedup" << '\n'
+            << ' ';
+  for (size_t i = 0; i < c1+c2+c3+c4+c5; ++i) std::cout << '-';
+  std::cout << '\n';
+
+  std::vector < KeyType > data(n), sorted;
+  for (size_t d = 0; d < sizeof(datasets) / sizeof(datasets[0]); ++d)
+  {
+    for (size_t i = 0; i < n; ++i)
+      data[i] = d ? Key(i) % dups : Key(i);
+    sorted = data;
+    std::sort(sorted.begin(), sorted.end());
+
+    for (size_t ki = 0; ki < ks.size(); ++ki)
+    {
+      double baseline = 0;
+      for (size_t m = 0; m < methods; ++m)
+      {
+        std::vector < double > usec;
+        bool ok = 1;
+        for (size_t r = 0; r < reps; ++r)
+          usec.push_back(Run(m, data, sorted, ks[ki], ok) * 1e6);
+        double median = fsu::Summarize(usec).median / 1e6; // seconds
+        if (m == 0) baseline = median;
+        std::cout << ' ' << std::left << std::setw(c1) << names[m] << std::setw(c2) << datasets[d] << std::right
+                  << std::setw(c3) << ks[ki]
+                  << std::setw(c4) << std::fixed << std::setprecision(2) << median * 1000
+                  << std::setw(c5) << std::setprecision(1) << baseline / median
+                  << std::setw(c6) << (ok ? "" : "WRONG") << '\n';
+      }
+    }
+  }
+  std::cout << '\n';
+  return 0;
+}
@@ -0,0 +1,356 @@
+/*
+    snet.h
+    10/19/26
+
+    sorting networks for the short ranges at the leaves of the optimized
+    quick and merge sorts
+
+      snet::SmallSort (T* beg, T* end)   // ascending, end - beg <= 32
+      snet::LeafSort  (beg, end [, cmp]) // what the _opt sorts call below their cutoff
+
+    Insertion sort on k elements makes O(k^2) data-dependent comparisons and
+    shifts, and its branches are unpredictable on random data. A bitonic
+    network makes a fixed sequence of compare-exchanges that compile to
+    min/max instructions, with no data-dependent branches at all.
+
+    A range of k <= 32 elements is copied to a buffer of 8, 16 or 32
+    elements, padded with the largest value of the type, sorted there and
+    copied back. With AVX2 (e.g. -mavx2 or -march=native) the network runs
+    8 (32-bit) or 4 (64-bit) lanes at a time in ymm registers; otherwise the
+    same network runs as scalar min/max.
+
+    Networks are used for uint32_t, int32_t, float and uint64_t arrays in
+    default order, i.e. with no predicate or with fsu::LessThan<T>, and with
+    fsu::Instrumented < fsu::LessThan<T> > (ginstrument.h), which counts
+    the network's compare-exchanges as comparisons and its copies in and
+    out as moves. Every other type, iterator or predicate (including the
+    counting spies) gets g_insertion_sort, so comparison counts stay
+    meaningful.
+
+    float: NaN has no place in the order and may end up anywhere, but the
+    output is a permutation of the input: a range that holds a NaN is
+    insertion sorted, and -0.0 and +0.0, which compare equal, keep their
+    signs.
+*/
+
+#ifndef _SNET_H
+#define _SNET_H
+
+#include <cstdlib>   // size_t
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <compare.h> // LessThan
+#include <ginstrument.h>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace fsu
+{
+
+  // gsort.h
+  template < class BidirectionalIterator >
+  void g_insertion_sort (BidirectionalIterator beg, BidirectionalIterator end);
+  template < class BidirectionalIterator, class Comparator >
+  void g_insertion_sort (BidirectionalIterator beg, BidirectionalIterator end, Comparator& cmp);
+  template < typename T >
+  void g_insertion_sort (T* beg, T* end);
+  template < typename T , class Comparator >
+  void g_insertion_sort (T* beg, T* end, Comparator& cmp);
+
+  namespace snet
+  {
+
+    const size_t max_size = 32; // longest range a network sorts
+
+    // types with a network: arithmetic, default order, a largest value to pad with
+    template < typename T > struct HasNetwork            { static const bool value = 0; };
+    template < >            struct HasNetwork<uint32_t>  { static const bool value = 1; };
+    template < >            struct HasNetwork<int32_t>   { static const bool value = 1; };
+    template < >            struct HasNetwork<float>     { static const bool value = 1; };
+    template < >            struct HasNetwork<uint64_t>  { static const bool value = 1; };
+
+    template < typename T >
+    inline T PadValue ()
+    {
+      return std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity()
+                                                  : std::numeric_limits<T>::max();
+    }
+
+    //----------------------------------
+    //     scalar network
+    //----------------------------------
+
+    template < typename T >
+    inline void CX (T& a, T& b) // compare-exchange: a <= b afterwards
+    {
+      T lo = (b < a) ? b : a;
+      T hi = (b < a) ? a : b;
+      a = lo;
+      b = hi;
+    }
+
+    // bitonic sort of x[0,N), N a power of 2
+    template < typename T , size_t N >
+    void BitonicScalar (T* x)
+    {
+      for (size_t k = 2; k <= N; k <<= 1)
+        for (size_t j = k >> 1; j > 0; j >>= 1)
+          for (size_t i = 0; i < N; ++i)
+          {
+            size_t p = i ^ j;
+            if (p > i)
+            {
+              if ((i & k) == 0) CX(x[i], x[p]); // ascending block
+              else              CX(x[p], x[i]); // descending block
+            }
+          }
+    }
+
+#ifdef __AVX2__
+
+    //----------------------------------
+    //     AVX2 network
+    //----------------------------------
+
+    // lane operations, all on __m256i; Lanes elements per register.
+    // Min(a,b) and Max(a,b) exchange a and b exactly when b < a.
+    template < typename T > struct Lanes;
+
+    template < > struct Lanes<uint32_t>
+    {
+      static const size_t count = 8;
+      static __m256i Min (__m256i a, __m256i b) { return _mm256_min_epu32(a, b); }
+      static __m256i Max (__m256i a, __m256i b) { return _mm256_max_epu32(a, b); }
+    };
+
+    template < > struct Lanes<int32_t>
+    {
+      static const size_t count = 8;
+      static __m256i Min (__m256i a, __m256i b) { return _mm256_min_epi32(a, b); }
+      static __m256i Max (__m256i a, __m256i b) { return _mm256_max_epi32(a, b); }
+    };
+
+    template < > struct Lanes<float>
+    {
+      static const size_t count = 8;
+      // not _mm256_min_ps/_mm256_max_ps: they return b when a and b compare
+      // equal or unordered, so -0.0 and +0.0 (or a NaN) would come out as
+      // two copies of one. Min and Max swap on the same test, as CX does.
+      static __m256 Greater (__m256i a, __m256i b) // b < a
+      { return _mm256_cmp_ps(_mm256_castsi256_ps(b), _mm256_castsi256_ps(a), _CMP_LT_OQ); }
+      static __m256i Min (__m256i a, __m256i b)
+      { return _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b), Greater(a, b))); }
+      static __m256i Max (__m256i a, __m256i b)
+      { return _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(b), _mm256_castsi256_ps(a), Greater(a, b))); }
+    };
+
+    template < > struct Lanes<uint64_t>
+    {
+      static const size_t count = 4;
+      // AVX2 has no unsigned 64-bit min/max: compare with the sign bits flipped
+      static __m256i Greater (__m256i a, __m256i b)
+      {
+        const __m256i sign = _mm256_set1_epi64x((long long)0x8000000000000000ULL);
+        return _mm256_cmpgt_epi64(_mm256_xor_si256(a, sign), _mm256_xor_si256(b, sign));
+      }
+      static __m256i Min (__m256i a, __m256i b) { return _mm256_blendv_epi8(a, b, Greater(a, b)); }
+      static __m256i Max (__m256i a, __m256i b) { return _mm256_blendv_epi8(b, a, Greater(a, b)); }
+    };
+
+    // bitonic sort of x[0,N) held in N / Lanes registers
+    template < typename T , size_t N >
+    void BitonicAVX2 (T* x)
+    {
+      typedef Lanes<T> L;
+      const size_t lanes = L::count;
+      const size_t regs  = N / lanes;
+      const int    width = (int)(sizeof(T) / 4); // 32-bit slots per element
+
+      __m256i v [regs];
+      for (size_t r = 0; r < regs; ++r)
+        v[r] = _mm256_loadu_si256((const __m256i*)(x + r * lanes));
+
+      // element index held in each 32-bit slot of register 0
+      const __m256i slot = (width == 1) ? _mm256_setr_epi32(0,1,2,3,4,5,6,7)
+                                        : _mm256_setr_epi32(0,0,1,1,2,2,3,3);
+      const __m256i slot32 = _mm256_setr_epi32(0,1,2,3,4,5,6,7);
+      const __m256i zero = _mm256_setzero_si256();
+
+      for (size_t k = 2; k <= N; k <<= 1)
+      {
+        const __m256i kk = _mm256_set1_epi32((int)k);
+        for (size_t j = k >> 1; j > 0; j >>= 1)
+        {
+          if (j >= lanes) // partner is in another register
+          {
+            size_t d = j / lanes;
+            for (size_t r = 0; r < regs; ++r)
+            {
+              size_t p = r ^ d;
+              if (p < r) continue;
+              __m256i lo = L::Min(v[r], v[p]);
+              __m256i hi = L::Max(v[r], v[p]);
+              if (((r * lanes) & k) == 0) { v[r] = lo; v[p] = hi; }
+              else                        { v[r] = hi; v[p] = lo; }
+            }
+          }
+          else // partner is a lane of the same register
+          {
+            const __m256i perm = _mm256_xor_si256(slot32, _mm256_set1_epi32((int)(j * width)));
+            const __m256i jj   = _mm256_set1_epi32((int)j);
+            for (size_t r = 0; r < regs; ++r)
+            {
+              __m256i other = _mm256_permutevar8x32_epi32(v[r], perm);
+              // Min(v, other) in the lane that keeps lo and Max(other, v) in
+              // the one that keeps hi make the same test, so the two agree
+              // on whether to exchange
+              __m256i lo    = L::Min(v[r], other);
+              __m256i hi    = L::Max(other, v[r]);
+              __m256i index = _mm256_add_epi32(slot, _mm256_set1_epi32((int)(r * lanes)));
+              __m256i lower = _mm256_cmpeq_epi32(_mm256_and_si256(index, jj), zero);
+              __m256i desc  = _mm256_cmpeq_epi32(_mm256_and_si256(index, kk), kk);
+              __m256i takeLo = _mm256_xor_si256(lower, desc);
+              v[r] = _mm256_blendv_epi8(hi, lo, takeLo);
+            }
+          }
+        }
+      }
+
+      for (size_t r = 0; r < regs; ++r)
+        _mm256_storeu_si256((__m256i*)(x + r * lanes), v[r]);
+    }
+
+    template < typename T , size_t N >
+    inline void Bitonic (T* x) { BitonicAVX2<T,N>(x); }
+
+#else
+
+    template < typename T , size_t N >
+    inline void Bitonic (T* x) { BitonicScalar<T,N>(x); }
+
+#endif
+
+    //----------------------------------
+    //     entry points
+    //----------------------------------
+
+    template < typename T , size_t N >
+    void PadSort (T* beg, size_t n)
+    {
+      T x [N];
+      size_t i = 0;
+      for ( ; i < n; ++i) x[i] = beg[i];
+      for ( ; i < N; ++i) x[i] = PadValue<T>();
+      Bitonic<T,N>(x);
+      for (i = 0; i < n; ++i) beg[i] = x[i];
+    }
+
+    // Pre: HasNetwork<T>, end - beg <= max_size
+    // compare-exchanges of the network on N elements: N/2 per step,
+    // log2(N) * (log2(N) + 1) / 2 steps
+    inline size_t NetworkSize (size_t n)
+    {
+      if (n <= 8)  return 24;
+      if (n <= 16) return 80;
+      return 240;
+    }
+
+    // true if a NaN is in x[0,n); never, for the integer types
+    template < typename T >
+    inline bool HasUnordered (const T* x, size_t n)
+    {
+      for (size_t i = 0; i < n; ++i)
+        if (x[i] != x[i]) return 1;
+      return 0;
+    }
+
+    template < typename T >
+    void SmallSort (T* beg, T* end)
+    {
+      size_t n = end - beg;
+      if (n < 2)       return;
+      // a NaN unorders the network, which could then move a pad value in
+      // and an element out
+      else if (HasUnordered(beg, n)) g_insertion_sort(beg, end);
+      else if (n <= 8)  PadSort<T,8>(beg, n);
+      else if (n <= 16) PadSort<T,16>(beg, n);
+      else              PadSort<T,32>(beg, n);
+    }
+
+    template < typename T >
+    void LeafSort (T* beg, T* end, std::true_type)
+    {
+      if ((size_t)(end - beg) <= max_size)
+        SmallSort(beg, end);
+      else
+        g_insertion_sort(beg, end);
+    }
+
+    template < typename T >
+    void LeafSort (T* beg, T* end, std::false_type)
+    {
+      g_insertion_sort(beg, end);
+    }
+
+    // LeafSort: sorting network where there is one, insertion sort otherwise
+
+    template < class I , class P >
+    void LeafSort (I beg, I end, P& cmp)
+    {
+      g_insertion_sort(beg, end, cmp);
+    }
+
+    template < class I >
+    void LeafSort (I beg, I end)
+    {
+      g_insertion_sort(beg, end);
+    }
+
+    template < typename T >
+    void LeafSort (T* beg, T* end)
+    {
+      LeafSort(beg, end, std::integral_constant<bool, HasNetwork<T>::value>());
+    }
+
+    template < typename T >
+    void LeafSort (T* beg, T* end, fsu::LessThan<T>&)
+    {
+      LeafSort(beg, end, std::integral_constant<bool, HasNetwork<T>::value>());
+    }
+
+    template < typename T , class I >
+    void LeafSort (T* beg, T* end, Instrumented < fsu::LessThan<T> , I >& cmp, std::true_type)
+    {
+      size_t n = end - beg;
+      if (n > max_size)
+      {
+        g_insertion_sort(beg, end, cmp);
+        return;
+      }
+      if (n < 2) return;
+      I::Compare(NetworkSize(n));
+      I::Move(n + n);
+      SmallSort(beg, end);
+    }
+
+    template < typename T , class I >
+    void LeafSort (T* beg, T* end, Instrumented < fsu::LessThan<T> , I >& cmp, std::false_type)
+    {
+      g_insertion_sort(beg, end, cmp);
+    }
+
+    // the network, counted
+    template < typename T , class I >
+    void LeafSort (T* beg, T* end, Instrumented < fsu::LessThan<T> , I >& cmp)
+    {
+      LeafSort(beg, end, cmp, std::integral_constant<bool, HasNetwork<T>::value>());
+    }
+
+  } // namespace snet
+
+} // namespace fsu
+
+#endif
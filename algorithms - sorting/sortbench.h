@@ -0,0 +1,460 @@
+/*
+    sortbench.h
+    10/19/26
+
+    a registry of sorts, and a harness that times them with repetitions
+
+      fsu::SortRegistry < T > sorts;
+      sorts.Add("g_intro_sort", "comparison", 0, sort [, count [, baseline]]);
+      fsu::BenchOptions options;                         // sizes, shapes, reps, ...
+      std::vector < fsu::BenchResult > results = fsu::RunBenchmark(sorts, options, &std::cout);
+      fsu::WriteCsv(out, results, options);              // or WriteJson
+
+    Each sort is registered once, as a SortEntry: a name, a group, a function
+    that sorts a[0,n) with a pure predicate and, for comparison sorts, a
+    function that sorts a[0,n) with an Instrumented one (ginstrument.h) and
+    returns the counts. Flags mark the Theta(n^2) sorts and the entries that
+    do not leave the array sorted (partitions). baseline names the entry a
+    speedup is reported over; note, if set, says something about the last
+    run.
+
+    RunBenchmark sweeps every size and shape (datagen.h) of the options. For
+    each case it generates one input, shared by all the entries, and for
+    each entry sorts fresh copies of it: warmup untimed runs, the first of
+    which is instrumented for the counts, then reps timed ones with the pure
+    predicate. The instrumented run and the first timed one are checked for
+    order. Only the sort is timed (steady_clock), not the copy or the check.
+    The times are summarized as min, median, p95 (nearest rank), mean and
+    sample standard deviation, in microseconds; the median and min are the
+    figures to compare, the spread says how far to trust them.
+
+    With options.counters, each timed run is also counted by the hardware
+    performance counters (perfcount.h) that the host allows, and the median
+    of each count is reported with the times; counts the host does not give
+    are -1.
+
+    Results are written as CSV, one row per (entry, shape, size), or as one
+    JSON document with the options; either diffs cleanly between commits
+    run with the same options on the same host.
+*/
+
+#ifndef _SORTBENCH_H
+#define _SORTBENCH_H
+
+#include <cstdlib>   // size_t
+#include <cstdint>
+#include <cmath>
+#include <cstring>   // strchr
+#include <string>
+#include <vector>
+#include <algorithm> // std::sort of the samples
+#include <functional>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <datagen.h>
+#include <ginstrument.h>
+#include <perfcount.h>
+#include <tpool.h>
+
+namespace fsu
+{
+
+  // sort_quadratic: Theta(n^2) on every input; sort_worst_quadratic: on
+  // every input but uniform random data (a fixed pivot, or a 2-way
+  // partition on equal keys); sort_unchecked: does not leave a[0,n) sorted
+  enum SortFlags { sort_quadratic = 1, sort_unchecked = 2, sort_worst_quadratic = 4 };
+
+  template < typename T >
+  struct SortEntry
+  {
+    std::string name;
+    std::string group;    // e.g. "comparison", "parallel", "numeric"
+    unsigned    flags;    // SortFlags
+    std::function < void (T*, size_t) > sort;          // with a pure predicate
+    std::function < SortCounters (T*, size_t) > count; // instrumented: the counts; may be empty
+    std::string baseline; // name of the entry speedup is reported over, or ""
+    std::function < std::string () > note;       // about the last run; may be empty
+  };
+
+  template < typename T >
+  class SortRegistry
+  {
+  public:
+    typedef std::function < void (T*, size_t) >         SortFunction;
+    typedef std::function < SortCounters (T*, size_t) > CountFunction;
+
+    // returns the entry, to set a note on
+    SortEntry<T>& Add (const std::string& name, const std::string& group, unsigned flags,
+                       SortFunction sort, CountFunction count = CountFunction(),
+                       const std::string& baseline = std::string())
+    {
+      SortEntry<T> e;
+      e.name     = name;
+      e.group    = group;
+      e.flags    = flags;
+      e.sort     = sort;
+      e.count    = count;
+      e.baseline = baseline;
+      entries_.push_back(e);
+      return entries_.back();
+    }
+
+    size_t Size () const { return entries_.size(); }
+    const SortEntry<T>& operator [] (size_t i) const { return entries_[i]; }
+
+    // index of the entry called name, or Size()
+    size_t Find (const std::string& name) const
+    {
+      for (size_t i = 0; i < entries_.size(); ++i)
+        if (entries_[i].name == name) return i;
+      return entries_.size();
+    }
+
+  private:
+    std::vector < SortEntry<T> > entries_;
+  };
+
+  struct SampleStats
+  {
+    size_t reps;
+    double min, median, p95, mean, stddev; // microseconds
+  };
+
+  // summary of samples, which it sorts
+  inline SampleStats Summarize (std::vector < double >& samples)
+  {
+    SampleStats s = { samples.size(), 0, 0, 0, 0, 0 };
+    size_t n = samples.size();
+    if (n == 0) return s;
+    std::sort(samples.begin(), samples.end());
+    s.min    = samples[0];
+    s.median = (n % 2) ? samples[n/2] : (samples[n/2 - 1] + samples[n/2]) / 2;
+    s.p95    = samples[(size_t)std::ceil(0.95 * n) - 1];
+    double sum = 0;
+    for (size_t i = 0; i < n; ++i) sum += samples[i];
+    s.mean = sum / n;
+    if (n > 1)
+    {
+      double ss = 0;
+      for (size_t i = 0; i < n; ++i) ss += (samples[i] - s.mean) * (samples[i] - s.mean);
+      s.stddev = std::sqrt(ss / (n - 1));
+    }
+    return s;
+  }
+
+  // for the command lines of the bench programs
+
+  // false if text is not a comma separated list of positive numbers
+  inline bool ParseCounts (const char* text, std::vector < size_t >& counts)
+  {
+    counts.clear();
+    while (*text)
+    {
+      char* end;
+      unsigned long long n = std::strtoull(text, &end, 10);
+      if (end == text || (*end != ',' && *end != '\0') || n == 0) return 0;
+      counts.push_back((size_t)n);
+      text = (*end == ',') ? end + 1 : end;
+    }
+    return !counts.empty();
+  }
+
+  // name gets the part of arg before '='; returns the part after it, or 0
+  // if there is no '='
+  inline const char* SplitArgument (const char* arg, std::string& name)
+  {
+    const char* value = std::strchr(arg, '=');
+    name = value ? std::string(arg, value - arg) : std::string(arg);
+    return value ? value + 1 : 0;
+  }
+
+  // the message for an argument that is not understood
+  inline void BadArgument (std::ostream& os, const char* arg, const char* usage)
+  {
+    os << " ** bad argument " << arg << '\n'
+       << " ** arguments (all optional):\n"
+       << "     " << usage << '\n'
+       << " ** try again\n";
+  }
+
+  struct BenchOptions
+  {
+    std::vector < size_t >    sizes;
+    std::vector < DataShape > shapes;
+    size_t      reps;         // timed runs per case
+    size_t      warmup;       // untimed runs before them; at least 1, which is counted and checked
+    uint64_t    seed;         // for datagen
+    size_t      quadraticMax; // larger sizes skip the sort_quadratic entries, and
+                              // the sort_worst_quadratic ones on all but uniform
+    std::string only;         // run the entries whose name contains this
+    std::string label;        // recorded with the results, e.g. a commit id
+    bool        counters;     // read the performance counters too
+
+    BenchOptions () : reps(11), warmup(2), seed(1), quadraticMax(20000), counters(0)
+    {
+      static const size_t s [] = { 1000, 10000, 100000, 1000000 };
+      static const DataShape d [] = { shape_uniform, shape_sorted, shape_reverse,
+                                      shape_nearly_sorted, shape_few_unique };
+      sizes.assign(s, s + sizeof(s) / sizeof(s[0]));
+      shapes.assign(d, d + sizeof(d) / sizeof(d[0]));
+    }
+  };
+
+  struct BenchResult
+  {
+    std::string name, group;
+    DataShape   shape;
+    size_t      size;
+    size_t      warmup;      // untimed runs made: options.warmup, or 1 if that is 0
+    long long   errors;      // order errors in the checked runs; -1: unchecked
+    long long   comparisons; // -1: no count (nor moves, swaps, maxDepth)
+    long long   moves, swaps, maxDepth;
+    SampleStats stats;
+    PerfSample  counts;      // median of each counter over the reps
+  };
+
+  namespace bench
+  {
+
+    // count of a[i] < a[i-1]
+    template < typename T >
+    size_t OrderErrors (const T* a, size_t n)
+    {
+      size_t count = 0;
+      for (size_t i = 1; i < n; ++i)
+        if (a[i] < a[i-1]) ++count;
+      return count;
+    }
+
+    // the median of each counter; -1 where any sample lacks it
+    inline PerfSample MedianCounts (const std::vector < PerfSample >& samples)
+    {
+      PerfSample m;
+      if (samples.empty()) return m;
+      std::vector < long long > v(samples.size());
+      for (size_t e = 0; e < perf_event_count; ++e)
+      {
+        for (size_t i = 0; i < samples.size(); ++i)
+          v[i] = samples[i][e];
+        std::sort(v.begin(), v.end());
+        m.value[e] = (v[0] < 0) ? -1 : v[v.size() / 2];
+      }
+      for (size_t i = 0; i < samples.size(); ++i)
+        m.scaled = m.scaled || samples[i].scaled;
+      return m;
+    }
+
+    // the untimed runs RunBenchmark makes: the first is needed for the counts and the check
+    inline size_t Warmups (const BenchOptions& options)
+    {
+      return options.warmup ? options.warmup : 1;
+    }
+
+    inline double Microseconds (std::chrono::steady_clock::duration d)
+    {
+      return std::chrono::duration < double, std::micro > (d).count();
+    }
+
+    // name and group as CSV and JSON fields: quoted, with the quotes doubled
+    // (CSV) or escaped (JSON); the names here have no other special characters
+    inline std::string Quote (const std::string& s, bool json)
+    {
+      std::string q("\"");
+      for (size_t i = 0; i < s.size(); ++i)
+      {
+        if (s[i] == '"' || (json && s[i] == '\\')) q += json ? '\\' : '"';
+        q += s[i];
+      }
+      return q + '"';
+    }
+
+  } // namespace bench
+
+  template < typename T >
+  std::vector < BenchResult > RunBenchmark (const SortRegistry<T>& sorts, const BenchOptions& options,
+                                            std::ostream* progress = 0)
+  {
+    typedef std::chrono::steady_clock Clock;
+    std::vector < BenchResult > results;
+    size_t warmup = bench::Warmups(options);
+    std::vector < double > samples;
+    std::vector < PerfSample > counts;
+    PerfCounters perf;
+    if (options.counters && !perf.Open() && progress)
+      *progress << " ** no performance counters: " << perf.Error() << '\n';
+    for (size_t z = 0; z < options.sizes.size(); ++z)
+    {
+      size_t n = options.sizes[z];
+      std::vector < T > src(n), work(n);
+      for (size_t d = 0; d < options.shapes.size(); ++d)
+      {
+        DataSpec spec;
+        spec.shape = options.shapes[d];
+        spec.seed  = options.seed;
+        generate_data(src.data(), n, spec);
+        for (size_t e = 0; e < sorts.Size(); ++e)
+        {
+          const SortEntry<T>& entry = sorts[e];
+          if (entry.name.find(options.only) == std::string::npos) continue;
+          if ((entry.flags & sort_quadratic) && n > options.quadraticMax) continue;
+          if ((entry.flags & sort_worst_quadratic) && spec.shape != shape_uniform
+              && n > options.quadraticMax) continue;
+
+          BenchResult r;
+          r.name  = entry.name;
+          r.group = entry.group;
+          r.shape = spec.shape;
+          r.size  = n;
+          r.warmup = warmup;
+          r.errors = -1;
+          r.comparisons = r.moves = r.swaps = r.maxDepth = -1;
+          for (size_t w = 0; w < warmup; ++w)
+          {
+            std::copy(src.begin(), src.end(), work.begin());
+            if (w == 0 && entry.count)
+            {
+              SortCounters c = entry.count(work.data(), n);
+              r.comparisons = (long long)c.comparisons;
+              r.moves       = (long long)c.moves;
+              r.swaps       = (long long)c.swaps;
+              r.maxDepth    = (long long)c.maxDepth;
+            }
+            else
+              entry.sort(work.data(), n);
+            if (w == 0 && !(entry.flags & sort_unchecked))
+              r.errors = (long long)bench::OrderErrors(work.data(), n);
+          }
+          bool check = !(entry.flags & sort_unchecked);
+          samples.clear();
+          counts.clear();
+          for (size_t k = 0; k < options.reps; ++k)
+          {
+            std::copy(src.begin(), src.end(), work.begin());
+            if (perf.Any()) perf.Start();
+            Clock::time_point start = Clock::now();
+            entry.sort(work.data(), n);
+            Clock::time_point stop = Clock::now();
+            if (perf.Any()) counts.push_back(perf.Stop());
+            samples.push_back(bench::Microseconds(stop - start));
+            if (k == 0 && check) // the plain sort, which the times are of
+              r.errors += (long long)bench::OrderErrors(work.data(), n);
+          }
+          r.stats  = Summarize(samples);
+          r.counts = bench::MedianCounts(counts);
+          results.push_back(r);
+
+          if (progress)
+          {
+            std::ios::fmtflags flags = progress->flags();
+            std::streamsize precision = progress->precision(1);
+            *progress << ' ' << std::left << std::setw(26) << r.name
+                      << std::setw(14) << DataShapeName(r.shape)
+                      << std::right << std::setw(9) << r.size
+                      << std::setw(7) << r.errors
+                      << std::fixed
+                      << std::setw(13) << r.stats.min
+                      << std::setw(13) << r.stats.median
+                      << std::setw(13) << r.stats.p95
+                      << std::setw(11) << r.stats.stddev;
+            if (options.counters)
+              *progress << std::setprecision(2) << std::setw(7) << r.counts.IPC()
+                        << std::setw(13) << r.counts[perf_branch_misses];
+            *progress << '\n';
+            progress->flags(flags);
+            progress->precision(precision);
+          }
+        }
+      }
+    }
+    return results;
+  }
+
+  // the column heads for the progress lines of RunBenchmark
+  inline void WriteBenchHeader (std::ostream& os, bool counters = 0)
+  {
+    os << ' ' << std::left << std::setw(26) << "algorithm"
+       << std::setw(14) << "shape"
+       << std::right << std::setw(9) << "size"
+       << std::setw(7) << "errors"
+       << std::setw(13) << "min usec"
+       << std::setw(13) << "median"
+       << std::setw(13) << "p95"
+       << std::setw(11) << "stddev";
+    if (counters)
+      os << std::setw(7) << "IPC" << std::setw(13) << "br_misses";
+    os << '\n';
+  }
+
+  inline void WriteCsv (std::ostream& os, const std::vector < BenchResult >& results, const BenchOptions& options)
+  {
+    os << "label,algorithm,group,shape,size,reps,warmup,seed,errors,comparisons,moves,swaps,max_depth,"
+       << "min_us,median_us,p95_us,mean_us,stddev_us";
+    if (options.counters)
+      for (size_t e = 0; e < perf_event_count; ++e)
+        os << ',' << PerfCounters::Name((PerfEvent)e);
+    os << '\n';
+    std::ios::fmtflags flags = os.flags();
+    std::streamsize precision = os.precision(3);
+    os << std::fixed;
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+      const BenchResult& r = results[i];
+      os << bench::Quote(options.label, 0) << ',' << bench::Quote(r.name, 0) << ',' << r.group << ','
+         << DataShapeName(r.shape) << ',' << r.size << ',' << r.stats.reps << ',' << r.warmup << ','
+         << options.seed << ',' << r.errors << ',' << r.comparisons << ','
+         << r.moves << ',' << r.swaps << ',' << r.maxDepth << ','
+         << r.stats.min << ',' << r.stats.median << ',' << r.stats.p95 << ','
+         << r.stats.mean << ',' << r.stats.stddev;
+      if (options.counters)
+        for (size_t e = 0; e < perf_event_count; ++e)
+          os << ',' << r.counts[e];
+      os << '\n';
+    }
+    os.flags(flags);
+    os.precision(precision);
+  }
+
+  inline void WriteJson (std::ostream& os, const std::vector < BenchResult >& results, const BenchOptions& options)
+  {
+    std::ios::fmtflags flags = os.flags();
+    std::streamsize precision = os.precision(3);
+    os << std::fixed
+       << "{\n"
+       << "  \"label\": " << bench::Quote(options.label, 1) << ",\n"
+       << "  \"threads\": " << TaskPool::Default().Size() << ",\n"
+       << "  \"reps\": " << options.reps << ",\n"
+       << "  \"warmup\": " << bench::Warmups(options) << ",\n"
+       << "  \"seed\": " << options.seed << ",\n"
+       << "  \"results\": [";
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+      const BenchResult& r = results[i];
+      os << (i ? ",\n" : "\n")
+         << "    { \"algorithm\": " << bench::Quote(r.name, 1)
+         << ", \"group\": " << bench::Quote(r.group, 1)
+         << ", \"shape\": \"" << DataShapeName(r.shape) << '"'
+         << ", \"size\": " << r.size
+         << ", \"errors\": " << r.errors
+         << ", \"comparisons\": " << r.comparisons
+         << ", \"moves\": " << r.moves
+         << ", \"swaps\": " << r.swaps
+         << ", \"max_depth\": " << r.maxDepth
+         << ", \"min_us\": " << r.stats.min
+         << ", \"median_us\": " << r.stats.median
+         << ", \"p95_us\": " << r.stats.p95
+         << ", \"mean_us\": " << r.stats.mean
+         << ", \"stddev_us\": " << r.stats.stddev;
+      if (options.counters)
+        for (size_t e = 0; e < perf_event_count; ++e)
+          os << ", \"" << PerfCounters::Name((PerfEvent)e) << "\": " << r.counts[e];
+      os << " }";
+    }
+    os << "\n  ]\n}\n";
+    os.flags(flags);
+    os.precision(precision);
+  }
+
+} // namespace fsu
+
+#endif
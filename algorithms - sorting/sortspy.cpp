@@ -3,7 +3,9 @@
    09/26/15
    Chris Lacher
 
-   takes two arguments: input and output file names
+   takes two arguments: input and output file names, optionally followed
+   by "fast" and by "text" or "binary" to force the input format (which is
+   otherwise recognized: see binio.h)
 
    processes as follows: 
 
@@ -11,9 +13,9 @@
      for each sort:
        sorts data
        collects CPU time between start and end of sort
-       collects comp_count data for comparison sorts
+       collects comp_count, moves, swaps and recursion depth for comparison sorts
        writes timing data to output file (and screen)
-       writes comp_count data to output file (and screen)
+       writes the counts to output file (and screen)
 
    Timing is done with an array of data to minimize container overhead
    and pointer dereference time. The sizes of the data sets should be not much
@@ -21,11 +23,23 @@
    unsigned int data. Using that kind of data for larger data sets will produce
    a lot of repeated values [the pigeonhole principle...].
 
-   Comp_count data is collected using a "spy" less-than predicate object that
-   counts the number of times it is called. When "spy" is used, the timing data
-   is useful for relative comparison among the comparison sort algorithms, but
-   it is inflated by the cost of spying. Better time estimates can be obtained
-   using pure predicates.
+   The counts are collected through a less-than predicate instrumented at
+   compile time (ginstrument.h): the sorts report comparisons, element
+   moves, swaps, recursion depth and the balance of their partitions to
+   thread-local counters. The parallel sorts are counted too, over all
+   their threads. Counting is not free (ginstrument.h gives figures), so
+   each sort is timed with the plain predicate and counted in a second,
+   untimed run on the same data.
+
+   Called as "sortspy.x autotune <header> [fast]" it tunes instead: see
+   AutoTune below. Called as "sortspy.x bench <results.csv|.json> ..." it
+   times every sort with repetitions over generated data: see Bench below.
+
+   With the option "perf" the comparison table (and bench) also reports the
+   hardware performance counters of each timed run: cycles, instructions,
+   instructions per cycle, branch misses, L1 data, last level cache and
+   data TLB misses, and page faults (perfcount.h). A counter the host does
+   not give shows as "-"; with none at all the run goes on without them.
 
    Types are important for other reasons as well. The random number generator
    uses the extra bits in unsigned long as a kind of larger universe to stir up
@@ -42,24 +56,40 @@
 #include <cstdint>
 #include <cmath>
 #include <climits>
+#include <cstring>
+#include <cstdio>
+#include <string>
+#include <sstream>
+#include <vector>
+#include <algorithm>
 #include <vector.h>
 #include <genalg.h>
-// #include <gheap.h>       // used in cop4530
+#include <gheap.h>          // advanced set; also needed by gsort.h
 // #include <gheap_basic.h> // used in cop4530
-#include <gheap_advanced.h>
+// #include <gheap_advanced.h>
 #include <gheap_cormen.h>
 #include <gsort.h>
+#include <gsort_par.h>
+#include <gsort_auto.h>
+#include <gsort_key.h>
 #include <nsort.h>
+#include <rsort.h>
+#include <binio.h>
+#include <sortbench.h>
+#include <perfcount.h>
 #include <timer.cpp>
 #include <list.h>
 #include <insert.h>
-#include <compare_spy.h>
+#include <ginstrument.h>
 #include <compare.h>
+#include <xran.h>
+#include <xran.cpp>         // in lieu of makefile
 // #include <gran.h>        // g_random_shuffle
 
 const int c1 = 20;
 // const int c1 = 24;       // space needed for randomized cases
 const int c2 = 10, c3 = 15, c4 = 6, c5 = 15, c6 = 15; // column widths
+const int c7 = 14, c8 = 6;                            // counter and IPC columns
 
 typedef uint32_t ElementType;
 
@@ -92,6 +122,771 @@ size_t CheckOrder (I beg, I end, P& p, bool verbose = 0)
 
 typedef uint32_t NumberType;
 
+// a fat record, for comparing sorts that move whole elements with
+// g_sort_by_key, which moves (key, index) pairs and each record once
+struct Record
+{
+  NumberType key;
+  char       payload [252];
+  bool operator < (const Record& r) const { return key < r.key; }
+};
+
+std::ostream& operator << (std::ostream& os, const Record& r) { return os << r.key; }
+
+struct RecordKey
+{
+  NumberType operator () (const Record& r) const { return r.key; }
+};
+
+const size_t recordMax = 262144; // at most 64 MB of records
+
+// The same strings as std::string and as CopyString, which has only copy
+// operations: the sorts move the first and deep-copy the second, so the
+// difference between the two rows is what moving saves.
+struct CopyString
+{
+  std::string s;
+  CopyString () {}
+  CopyString (const CopyString& x) : s(x.s) {}
+  CopyString& operator = (const CopyString& x) { s = x.s; return *this; }
+  bool operator < (const CopyString& x) const { return s < x.s; }
+};
+
+std::ostream& operator << (std::ostream& os, const CopyString& x) { return os << x.s; }
+
+const size_t stringMax = 262144;
+
+/*
+   the registry
+
+   Every sort of the comparison table, and each numeric sort at each
+   width, is registered once here (sortbench.h): the tables are made from
+   the registries, and "sortspy.x bench" times the same entries with
+   repetitions over a sweep of sizes and shapes. A comparison sort is
+   registered through a functor, which is run with LessThan, or with
+   LessThan instrumented (ginstrument.h) where the counts are wanted too.
+*/
+
+struct SelectionSort
+{
+  template < class I , class P > void operator () (I beg, I end, P& cmp) const { fsu::g_selection_sort(beg, end, cmp); }
+};
+
+struct InsertionSort
+{
+  template < class I , class P > void operator () (I beg, I end, P& cmp) const { fsu::g_insertion_sort(beg, end, cmp); }
+};
+
+struct QuickSort
+{
+  template < class I , class P > void operator () (I beg, I end, P& cmp) const { fsu::g_quick_sort(beg, end, cmp); }
+};
+
+struct QuickSortOpt
+{
+  template < class I , class P > void operator () (I beg, I end, P& cmp) const { fsu::g_quick_sort_opt(beg, end, cmp); }
+};
+
+struct QuickSort3w
+{
+  template < class I , class P > void operator () (I beg, I end, P& cmp) const { fsu::g_quick_sort_3w(beg, end, cmp); }
+};
+
+struct QuickSort3wOpt
+{
+  template < class I , class P > void operator () (I beg, I end, P& cmp) const { fsu::g_quick_sort_3w_opt(beg, end, cmp); }
+};
+
+struct IntroSort
+{
+  template < class I , class P > void operator () (I beg, I end, P& cmp) const { fsu::g_intro_sort(beg, end, cmp); }
+};
+
+// one partition of the whole range, pivot = last element: Lomuto vs block.
+// Comparison counts are about the same; on random data the time difference is the
+// branch mispredictions that the block partition removes.
+struct LomutoPartition
+{
+  template < class I , class P > void operator () (I beg, I end, P& cmp) const
+  { if (end - beg > 1) fsu::quicksort::LomutoPartition(beg, end - 1, cmp); }
+};
+
+struct BlockPartition
+{
+  template < class I , class P > void operator () (I beg, I end, P& cmp) const
+  { if (end - beg > 1) fsu::quicksort::BlockPartition(beg, end - 1, cmp); }
+};
+
+struct MergeSort
+{
+  template < class I , class P > void operator () (I beg, I end, P& cmp) const { fsu::g_merge_sort(beg, end, cmp); }
+};
+
+struct MergeSortOpt
+{
+  template < class I , class P > void operator () (I beg, I end, P& cmp) const { fsu::g_merge_sort_opt(beg, end, cmp); }
+};
+
+struct MergeSortAdaptive
+{
+  template < class I , class P > void operator () (I beg, I end, P& cmp) const { fsu::g_merge_sort_adaptive(beg, end, cmp); }
+};
+
+struct MergeSortBu
+{
+  template < class I , class P > void operator () (I beg, I end, P& cmp) const { fsu::g_merge_sort_bu(beg, end, cmp); }
+};
+
+struct AltHeapSort
+{
+  template < class I , class P > void operator () (I beg, I end, P& cmp) const { alt::g_heap_sort(beg, end, cmp); }
+};
+
+struct HeapSort
+{
+  template < class I , class P > void operator () (I beg, I end, P& cmp) const { fsu::g_heap_sort(beg, end, cmp); }
+};
+
+struct CormenHeapSort
+{
+  template < class I , class P > void operator () (I beg, I end, P& cmp) const { cormen::g_heap_sort(beg, end, cmp); }
+};
+
+struct BottomUpHeapSort
+{
+  template < class I , class P > void operator () (I beg, I end, P& cmp) const { fsu::g_heap_sort_bu(beg, end, cmp); }
+};
+
+template < size_t D >
+struct DaryHeapSort
+{
+  template < class I , class P > void operator () (I beg, I end, P& cmp) const { fsu::g_heap_sort_dary<D>(beg, end, cmp); }
+};
+
+struct ParallelMergeSort
+{
+  template < class I , class P > void operator () (I beg, I end, P& cmp) const { fsu::g_parallel_merge_sort(beg, end, cmp); }
+};
+
+struct ParallelQuickSort
+{
+  template < class I , class P > void operator () (I beg, I end, P& cmp) const { fsu::g_parallel_quick_sort(beg, end, cmp); }
+};
+
+struct ParallelQuickSort3w
+{
+  template < class I , class P > void operator () (I beg, I end, P& cmp) const { fsu::g_parallel_quick_sort_3w(beg, end, cmp); }
+};
+
+typedef fsu::SortRegistry < ElementType > Registry;
+typedef fsu::Instrumented < fsu::LessThan < ElementType > > CountingLessThan;
+
+template < class S >
+void AddSort (Registry& sorts, const char* name, const char* group, unsigned flags = 0,
+              const char* baseline = "")
+{
+  sorts.Add(name, group, flags,
+            [](ElementType* a, size_t n) { fsu::LessThan < ElementType > lt; S()(a, a + n, lt); },
+            [](ElementType* a, size_t n)
+            {
+              CountingLessThan cmp;
+              fsu::CountInstrument::Reset();
+              S()(a, a + n, cmp);
+              return fsu::CountInstrument::Total();
+            },
+            baseline);
+}
+
+fsu::SortDecision lastDecision; // of the last g_sort run
+
+void RegisterSorts (Registry& sorts)
+{
+  AddSort < SelectionSort >     (sorts, "g_selection_sort",   "comparison", fsu::sort_quadratic);
+  AddSort < InsertionSort >     (sorts, "g_insertion_sort",   "comparison", fsu::sort_quadratic);
+  AddSort < QuickSort >         (sorts, "g_quick_sort",       "comparison", fsu::sort_worst_quadratic);
+  AddSort < QuickSortOpt >      (sorts, "g_quick_sort_opt",   "comparison");
+  AddSort < QuickSort3w >       (sorts, "g_quick_sort_3w",    "comparison", fsu::sort_worst_quadratic);
+  AddSort < QuickSort3wOpt >    (sorts, "g_quick_sort_3w_opt","comparison");
+  AddSort < IntroSort >         (sorts, "g_intro_sort",       "comparison");
+  AddSort < LomutoPartition >   (sorts, "Partition (Lomuto)", "partition", fsu::sort_unchecked);
+  AddSort < BlockPartition >    (sorts, "Partition (block)",  "partition", fsu::sort_unchecked);
+  AddSort < MergeSort >         (sorts, "g_merge_sort",       "comparison");
+  AddSort < MergeSortOpt >      (sorts, "g_merge_sort_opt",   "comparison");
+  AddSort < MergeSortAdaptive > (sorts, "g_merge_sort_adapt", "comparison");
+  AddSort < MergeSortBu >       (sorts, "g_merge_sort_bu",    "comparison");
+
+  AddSort < ParallelMergeSort >   (sorts, "g_parallel_merge_sort",    "parallel", 0, "g_merge_sort");
+  AddSort < ParallelQuickSort >   (sorts, "g_parallel_quick_sort",    "parallel", 0, "g_quick_sort_opt");
+  AddSort < ParallelQuickSort3w > (sorts, "g_parallel_quick_sort_3w", "parallel", 0, "g_quick_sort_3w_opt");
+
+  // adaptive front end: the choice depends on the data, so no comp_count
+  sorts.Add("g_sort", "adaptive", 0,
+            [](ElementType* a, size_t n) { fsu::LessThan < ElementType > lt; lastDecision = fsu::g_sort(a, a + n, lt); })
+    .note = []() { std::ostringstream os; os << "chose " << lastDecision; return os.str(); };
+
+  AddSort < AltHeapSort >       (sorts, "alt::g_heap_sort",    "heap");
+  AddSort < HeapSort >          (sorts, "fsu::g_heap_sort",    "heap");
+  AddSort < CormenHeapSort >    (sorts, "cormen::g_heap_sort", "heap");
+  AddSort < BottomUpHeapSort >  (sorts, "fsu::g_heap_sort_bu", "heap", 0, "fsu::g_heap_sort");
+  AddSort < DaryHeapSort<4> >   (sorts, "g_heap_sort_dary<4>", "heap", 0, "fsu::g_heap_sort");
+  AddSort < DaryHeapSort<8> >   (sorts, "g_heap_sort_dary<8>", "heap", 0, "fsu::g_heap_sort");
+}
+
+// the numeric sorts, registered at each width they sort: bit_sort<8> ..
+// radix_sort<64>. The note of an entry is its outer loop count, in the
+// two columns the Numerical Sorts table has for it.
+
+size_t lastLoops; // outer loop count of the last numeric sort run
+
+template < typename T , class F >
+void AddNumeric (fsu::SortRegistry<T>& sorts, const char* name, const char* unit, F sort)
+{
+  std::string u(unit);
+  sorts.Add(std::string(name) + '<' + std::to_string(8 * sizeof(T)) + '>', "numeric", 0,
+            [sort](T* a, size_t n) { lastLoops = sort(a, n); })
+    .note = [u]() { std::ostringstream os; os << std::setw(c3) << u << std::setw(c4) << lastLoops; return os.str(); };
+}
+
+// word_sort needs at least two bytes
+template < typename T >
+void AddWordSort (fsu::SortRegistry<T>& sorts)
+{
+  AddNumeric(sorts, "word_sort", "words", [](T* a, size_t n) { return fsu::word_sort(a, n); });
+}
+
+inline void AddWordSort (fsu::SortRegistry<uint8_t>&) {}
+
+template < typename T >
+void RegisterNumericSorts (fsu::SortRegistry<T>& sorts)
+{
+  AddNumeric(sorts, "bit_sort",   "bits",   [](T* a, size_t n) { return fsu::bit_sort(a, n); });
+  AddNumeric(sorts, "byte_sort",  "bytes",  [](T* a, size_t n) { return fsu::byte_sort(a, n); });
+  AddWordSort(sorts);
+  AddNumeric(sorts, "radix_sort", "passes", [](T* a, size_t n) { return fsu::radix_sort(a, n); });
+}
+
+struct NumericRegistries
+{
+  fsu::SortRegistry < uint8_t >  w8;
+  fsu::SortRegistry < uint16_t > w16;
+  fsu::SortRegistry < uint32_t > w32;
+  fsu::SortRegistry < uint64_t > w64;
+
+  NumericRegistries ()
+  {
+    RegisterNumericSorts(w8);
+    RegisterNumericSorts(w16);
+    RegisterNumericSorts(w32);
+    RegisterNumericSorts(w64);
+  }
+};
+
+// the counter column heads (or their underlines), if there are counters
+void PerfHeads (std::ostream& os, const fsu::PerfCounters* perf, bool dashes)
+{
+  if (perf)
+  {
+    const char* heads [] = { "cycles", "instructions", "IPC", "br_misses", "L1d_misses",
+                             "LLC_misses", "dTLB_misses", "faults" };
+    for (size_t i = 0; i < sizeof(heads) / sizeof(heads[0]); ++i)
+      os << std::setw(i == 2 ? c8 : c7) << (dashes ? (i == 2 ? "---" : "----------") : heads[i]);
+  }
+  os << '\n';
+}
+
+// one row of the comparison table; long names borrow from the errors column.
+// counters are those of ginstrument.h, counts those of perfcount.h; either
+// may be missing.
+void TableRow (std::ostream& os, const std::string& name, const std::string& errors,
+               const fsu::SortCounters* counters, const fsu::Instant& instant,
+               const fsu::PerfSample* counts = 0)
+{
+  int over = (int)name.size() + 1 - c1;
+  os << std::left << std::setw(c1) << (' ' + name)
+     << std::right << std::setw(over > 0 ? c2 - over : c2) << errors;
+  if (counters)
+    os << std::setw(c3) << counters->comparisons
+       << std::setw(c3) << counters->moves
+       << std::setw(c3) << counters->swaps
+       << std::setw(c4) << counters->maxDepth;
+  else
+    os << std::setw(c3) << " -" << std::setw(c3) << " -" << std::setw(c3) << " -" << std::setw(c4) << " -";
+  os << std::setw(c5) << instant.Get_useconds()
+     << std::setw(c6) << instant.Get_seconds();
+  if (counts)
+  {
+    const fsu::PerfEvent events [] = { fsu::perf_cycles, fsu::perf_instructions, fsu::perf_branch_misses,
+                                       fsu::perf_l1d_misses, fsu::perf_llc_misses, fsu::perf_dtlb_misses,
+                                       fsu::perf_page_faults };
+    for (size_t i = 0; i < sizeof(events) / sizeof(events[0]); ++i)
+    {
+      long long v = (*counts)[events[i]];
+      if (v < 0) os << std::setw(c7) << "-";
+      else       os << std::setw(c7) << v;
+      if (events[i] == fsu::perf_instructions)
+      {
+        std::streamsize precision = os.precision(2);
+        if (counts->IPC() > 0) os << std::setw(c8) << counts->IPC();
+        else                   os << std::setw(c8) << "-";
+        os.precision(precision);
+      }
+    }
+  }
+  os << '\n';
+}
+
+// the partition balance line: the share of partitions whose smaller side
+// is 0-5%, 5-10%, ... 45-50% of the partitioned elements
+std::string BalanceLine (const fsu::SortCounters& counters)
+{
+  std::ostringstream line;
+  line << "   balance (smaller side 0-5% .. 45-50%, % of " << counters.partitions << " partitions):";
+  for (size_t i = 0; i < fsu::balance_bins; ++i)
+    line << std::setw(4) << (100 * counters.balance[i] + counters.partitions / 2) / counters.partitions;
+  return line.str();
+}
+
+// the table rows of the entries in groups, in registry order, sorting copies
+// of src[0,n); times[i] keeps entry i's time for the speedup lines. Each
+// entry has a timed run with the plain predicate, counted by perf if there
+// is one and checked for order, and then, if it has counts, an untimed
+// instrumented run for them, so the counting never shows in the times.
+void TableRows (const Registry& sorts, const std::vector < std::string >& groups,
+                const ElementType* src, ElementType* data, size_t n, bool fast,
+                std::vector < fsu::Instant >& times, fsu::PerfCounters* perf, std::ostream& out1)
+{
+  fsu::Timer timer;
+  fsu::LessThan < ElementType > lt;
+  for (size_t e = 0; e < sorts.Size(); ++e)
+  {
+    const fsu::SortEntry < ElementType >& entry = sorts[e];
+    if (std::find(groups.begin(), groups.end(), entry.group) == groups.end()) continue;
+    if (fast && (entry.flags & fsu::sort_quadratic)) continue;
+    bool checked = !(entry.flags & fsu::sort_unchecked);
+    fsu::g_copy (src, src + n, data);
+    fsu::SortCounters counters;
+    fsu::PerfSample counts;
+    if (perf) perf->Start();
+    timer.SplitReset();
+    entry.sort(data, n);
+    times[e] = timer.SplitTime();
+    if (perf) counts = perf->Stop();
+    std::string errors = checked ? std::to_string(CheckOrder(data,data+n,lt,0)) : std::string(" -");
+    if (entry.count)
+    {
+      fsu::g_copy (src, src + n, data);
+      counters = entry.count(data, n);
+    }
+    const fsu::SortCounters* c = entry.count ? &counters : 0;
+    TableRow(std::cout, entry.name, errors, c, times[e], perf ? &counts : 0);
+    TableRow(out1,      entry.name, errors, c, times[e], perf ? &counts : 0);
+    if (counters.partitions > 0)
+    {
+      std::cout << BalanceLine(counters) << '\n';
+      out1      << BalanceLine(counters) << '\n';
+    }
+
+    size_t b = sorts.Find(entry.baseline);
+    if (b < sorts.Size() && times[e].Get_seconds() > 0)
+    {
+      std::ostringstream line;
+      line << "   speedup over " << entry.baseline << ": " << std::fixed << std::setprecision(2)
+           << times[b].Get_seconds() / times[e].Get_seconds();
+      if (entry.group == "parallel")
+        line << " (" << fsu::TaskPool::Default().Size() << " threads)";
+      std::cout << line.str() << '\n';
+      out1      << line.str() << '\n';
+    }
+    if (entry.note)
+    {
+      std::cout << "   " << entry.note() << '\n';
+      out1      << "   " << entry.note() << '\n';
+    }
+  }
+}
+
+// one row of the Numerical Sorts table; loops is the two outer loop columns
+void NumericRow (std::ostream& os, const std::string& name, size_t errors, const std::string& loops,
+                 const fsu::Instant& instant)
+{
+  os << std::left << std::setw(c1) << (' ' + name)
+     << std::right << std::setw(c2) << errors
+     << loops
+     << std::setw(c5) << instant.Get_useconds()
+     << std::setw(c6) << instant.Get_seconds()
+     << '\n';
+}
+
+// the Numerical Sorts rows of the entries of one width, sorting copies of
+// src[0,n) converted to T (narrower widths keep the low bits)
+template < typename T , class I >
+void NumericRows (const fsu::SortRegistry<T>& sorts, I src, size_t n, std::ostream& out1)
+{
+  fsu::Timer timer;
+  fsu::LessThan < T > lt;
+  std::vector < T > data(n);
+  for (size_t e = 0; e < sorts.Size(); ++e)
+  {
+    const fsu::SortEntry < T >& entry = sorts[e];
+    fsu::g_copy (src, src + n, data.data());
+    timer.SplitReset();
+    entry.sort(data.data(), n);
+    fsu::Instant instant = timer.SplitTime();
+    size_t errors = CheckOrder(data.data(), data.data() + n, lt, 0);
+    std::string loops = entry.note ? entry.note() : std::string();
+    NumericRow(std::cout, entry.name, errors, loops, instant);
+    NumericRow(out1,      entry.name, errors, loops, instant);
+  }
+}
+
+/*
+   bench
+
+   "sortspy.x bench <results.csv|results.json> [name=value ...]" runs every
+   registered sort (sortbench.h) on generated data (datagen.h) and writes
+   the statistics, as JSON if the file name ends in .json, else as CSV:
+
+     sizes=1000,10000,100000,1000000
+     shapes=uniform,sorted,reverse,nearly_sorted,few_unique   (or "all")
+     reps=11 warmup=2 seed=1
+     only=<text>       the sorts whose name contains text
+     label=<text>      recorded with the results, e.g. the commit
+     quadratic=20000   largest size for the Theta(n^2) sorts, and for the plain
+                       quicksorts on all but uniform; "fast" is quadratic=0
+     perf              the medians of the performance counters too (perfcount.h)
+
+   Run two commits with the same options on a quiet machine and diff the
+   files; a median that moves by less than the stddev has not moved.
+*/
+
+// false if text is not a list of numbers
+bool ParseSizes (const char* text, std::vector < size_t >& sizes)
+{
+  sizes.clear();
+  while (*text)
+  {
+    char* end;
+    unsigned long long n = std::strtoull(text, &end, 10);
+    if (end == text || (*end != ',' && *end != '\0')) return 0;
+    sizes.push_back((size_t)n);
+    text = (*end == ',') ? end + 1 : end;
+  }
+  return !sizes.empty();
+}
+
+// false if text is not a list of shapes
+bool ParseShapes (const char* text, std::vector < fsu::DataShape >& shapes)
+{
+  shapes.clear();
+  if (std::strcmp(text, "all") == 0)
+  {
+    for (size_t i = 0; i < fsu::datagen::shape_count; ++i)
+      shapes.push_back((fsu::DataShape)i);
+    return 1;
+  }
+  std::string list(text);
+  size_t start = 0;
+  while (start <= list.size())
+  {
+    size_t comma = list.find(',', start);
+    if (comma == std::string::npos) comma = list.size();
+    fsu::DataShape shape;
+    if (!fsu::ParseDataShape(list.substr(start, comma - start).c_str(), shape)) return 0;
+    shapes.push_back(shape);
+    start = comma + 1;
+  }
+  return 1;
+}
+
+// RunBenchmark of sorts, appended to results
+template < typename T >
+void BenchMore (std::vector < fsu::BenchResult >& results, const fsu::SortRegistry<T>& sorts,
+                const fsu::BenchOptions& options)
+{
+  std::vector < fsu::BenchResult > more = fsu::RunBenchmark(sorts, options, &std::cout);
+  results.insert(results.end(), more.begin(), more.end());
+}
+
+int Bench (int argc, char* argv[])
+{
+  const char* outfile = argv[2];
+  fsu::BenchOptions options;
+  for (int i = 3; i < argc; ++i)
+  {
+    const char* arg = argv[i];
+    const char* value = std::strchr(arg, '=');
+    std::string name = value ? std::string(arg, value - arg) : std::string(arg);
+    bool ok = 1;
+    if (value) ++value;
+    if      (name == "fast" && !value)  options.quadraticMax = 0;
+    else if (name == "perf" && !value)  options.counters = 1;
+    else if (!value)                    ok = 0;
+    else if (name == "sizes")           ok = ParseSizes(value, options.sizes);
+    else if (name == "shapes")          ok = ParseShapes(value, options.shapes);
+    else if (name == "reps")            ok = (options.reps = std::strtoull(value, 0, 10)) > 0;
+    else if (name == "warmup")          options.warmup = std::strtoull(value, 0, 10);
+    else if (name == "seed")            options.seed = std::strtoull(value, 0, 10);
+    else if (name == "quadratic")       options.quadraticMax = std::strtoull(value, 0, 10);
+    else if (name == "only")            options.only = value;
+    else if (name == "label")           options.label = value;
+    else                                ok = 0;
+    if (!ok)
+    {
+      std::cout << " ** bad option " << arg << '\n'
+                << " ** try again\n";
+      return 0;
+    }
+  }
+  std::ofstream out1(outfile);
+  if (out1.fail())
+  {
+    std::cout << " ** cannot open file " << outfile << " for write\n"
+              << " ** try again\n";
+    return 0;
+  }
+  size_t length = std::strlen(outfile);
+  bool json = length >= 5 && std::strcmp(outfile + length - 5, ".json") == 0;
+
+  Registry sorts;
+  RegisterSorts(sorts);
+  std::cout << "\n Benchmark: " << options.reps << " reps after " << options.warmup
+            << " warmup, seed " << options.seed << ", "
+            << fsu::TaskPool::Default().Size() << " threads\n\n";
+  fsu::WriteBenchHeader(std::cout, options.counters);
+  std::vector < fsu::BenchResult > results = fsu::RunBenchmark(sorts, options, &std::cout);
+  NumericRegistries numeric;
+  BenchMore(results, numeric.w8,  options);
+  BenchMore(results, numeric.w16, options);
+  BenchMore(results, numeric.w32, options);
+  BenchMore(results, numeric.w64, options);
+  if (json)
+    fsu::WriteJson(out1, results, options);
+  else
+    fsu::WriteCsv(out1, results, options);
+  out1.close();
+  std::cout << "\n Results stored in file " << outfile << " (" << (json ? "JSON" : "CSV") << ")\n\n";
+  return 0;
+}
+
+// sorts a copy of src[0,n) with sort; one row of output
+template < typename S , class F >
+fsu::Instant StringRow (const char* name, const S* src, S* a, size_t n, F sort, std::ostream& out1)
+{
+  fsu::Timer timer;
+  for (size_t i = 0; i < n; ++i)
+    a[i] = src[i];
+  timer.SplitReset();
+  sort(a, a + n);
+  fsu::Instant instant = timer.SplitTime();
+  fsu::LessThan < S > lt;
+  std::string errors = std::to_string(CheckOrder(a, a + n, lt, 0));
+  TableRow(std::cout, name, errors, 0, instant);
+  TableRow(out1,      name, errors, 0, instant);
+  return instant;
+}
+
+void StringSpeedup (const fsu::Instant& moved, const fsu::Instant& copied, std::ostream& out1)
+{
+  if (moved.Get_seconds() <= 0) return;
+  std::cout << "   move speedup: " << std::setprecision(2)
+            << copied.Get_seconds() / moved.Get_seconds() << '\n' << std::setprecision(6);
+  out1      << "   move speedup: " << std::setprecision(2)
+            << copied.Get_seconds() / moved.Get_seconds() << '\n' << std::setprecision(6);
+}
+
+/*
+   autotune
+
+   For each element type and size class (gsort_policy.h), times g_intro_sort
+   over every cutoff and pivot rule, g_merge_sort_opt over every cutoff, and
+   then, with those winners, the parallel quick and merge sorts over every
+   grain. The fastest settings are written to the header as TunedPolicy
+   specializations; build with -DGSORT_TUNED to use them.
+
+   Each setting is timed as the best of 3 trials, a trial sorting copies of
+   one random data set until about tuneBudget elements have been sorted.
+*/
+
+const size_t tuneCutoffs [] = { 4, 8, 12, 16, 24, 32 };
+const size_t tuneGrains  [] = { 4096, 16384, 65536, 262144 };
+const fsu::PivotRule tunePivots [] = { fsu::pivot_last, fsu::pivot_median3, fsu::pivot_ninther };
+const char* const tunePivotNames [] = { "pivot_last", "pivot_median3", "pivot_ninther" };
+const char* const tuneClassNames [] = { "small", "medium", "large" };
+const size_t tuneSizes     [] = { 1000, 100000, 2000000 }; // one per size class
+const size_t tuneSizesFast [] = { 1000, 50000, 500000 };
+const size_t tuneBudget     = 1000000;
+const size_t tuneBudgetFast = 200000;
+
+template < typename T >
+void TuneFill (T* a, size_t n, fsu::Random_unsigned_int& ranuint)
+{
+  for (size_t i = 0; i < n; ++i)
+    a[i] = (T)ranuint(0, UINT_MAX);
+}
+
+// 32 random bits are not enough for 64-bit keys
+template < >
+void TuneFill (uint64_t* a, size_t n, fsu::Random_unsigned_int& ranuint)
+{
+  for (size_t i = 0; i < n; ++i)
+    a[i] = ((uint64_t)ranuint(0, UINT_MAX) << 32) | ranuint(0, UINT_MAX);
+}
+
+// best of 3 trials, in useconds, of sorting reps copies of src[0,n)
+template < typename T , class S >
+long long TuneTime (const T* src, T* dst, size_t n, size_t reps, S sort)
+{
+  fsu::Timer timer;
+  long long best = -1;
+  for (size_t trial = 0; trial < 3; ++trial)
+  {
+    timer.SplitReset();
+    for (size_t r = 0; r < reps; ++r)
+    {
+      fsu::g_copy(src, src + n, dst);
+      sort(dst, dst + n);
+    }
+    long long t = timer.SplitTime().Get_useconds();
+    if (best < 0 || t < best)
+      best = t;
+  }
+  return best;
+}
+
+void TuneWrite (std::ostream& out, const char* member, const fsu::SortPolicy<>* p)
+{
+  out << "    static SortPolicy<> " << member << " (size_t n)\n"
+      << "    {\n";
+  for (size_t c = 0; c < 3; ++c)
+  {
+    out << "      ";
+    if (c == 0)      out << "if (n < tune_small)  ";
+    else if (c == 1) out << "if (n < tune_medium) ";
+    out << "return SortPolicy<>(" << p[c].cutoff << ", "
+        << tunePivotNames[p[c].pivot] << ", " << p[c].grain << "); // "
+        << tuneClassNames[c] << '\n';
+  }
+  out << "    }\n";
+}
+
+template < typename T >
+void TuneType (const char* name, bool fast, std::ostream& header)
+{
+  const size_t* sizes  = fast ? tuneSizesFast : tuneSizes;
+  const size_t  budget = fast ? tuneBudgetFast : tuneBudget;
+  fsu::SortPolicy<> quick [3], merge [3];
+  fsu::LessThan < T > lt;
+  fsu::Random_unsigned_int ranuint;
+
+  for (size_t c = 0; c < 3; ++c)
+  {
+    size_t n = sizes[c];
+    size_t reps = (budget > n) ? budget / n : 1;
+    T* src = new T [n];
+    T* dst = new T [n];
+    TuneFill(src, n, ranuint);
+    fsu::MergeBuffer < T > buffer(n);
+    long long best, t;
+
+    best = -1;
+    for (size_t i = 0; i < sizeof(tuneCutoffs) / sizeof(size_t); ++i)
+      for (size_t j = 0; j < 3; ++j)
+      {
+        fsu::SortPolicy<> p(tuneCutoffs[i], tunePivots[j]);
+        t = TuneTime(src, dst, n, reps, [&](T* b, T* e) { fsu::g_intro_sort(b, e, lt, p); });
+        if (best < 0 || t < best) { best = t; quick[c] = p; }
+      }
+
+    best = -1;
+    for (size_t i = 0; i < sizeof(tuneCutoffs) / sizeof(size_t); ++i)
+    {
+      fsu::SortPolicy<> p(tuneCutoffs[i]);
+      t = TuneTime(src, dst, n, reps, [&](T* b, T* e) { fsu::g_merge_sort_opt(b, e, buffer, lt, p); });
+      if (best < 0 || t < best) { best = t; merge[c] = p; }
+    }
+
+    // grain only matters where there is more than one grain of work
+    long long bestQ = -1, bestM = -1;
+    for (size_t i = 0; i < sizeof(tuneGrains) / sizeof(size_t) && tuneGrains[i] < n; ++i)
+    {
+      fsu::SortPolicy<> q(quick[c]), m(merge[c]);
+      q.grain = m.grain = tuneGrains[i];
+      t = TuneTime(src, dst, n, reps, [&](T* b, T* e) { fsu::g_parallel_quick_sort(b, e, lt, q); });
+      if (bestQ < 0 || t < bestQ) { bestQ = t; quick[c].grain = q.grain; }
+      t = TuneTime(src, dst, n, reps, [&](T* b, T* e) { fsu::g_parallel_merge_sort(b, e, buffer, lt, fsu::TaskPool::Default(), m); });
+      if (bestM < 0 || t < bestM) { bestM = t; merge[c].grain = m.grain; }
+    }
+
+    std::cout << ' ' << std::left << std::setw(c2-1) << name
+              << std::setw(c2) << tuneClassNames[c]
+              << std::right << std::setw(c2) << n
+              << std::setw(c2) << quick[c].cutoff
+              << std::setw(c3) << tunePivotNames[quick[c].pivot]
+              << std::setw(c2) << quick[c].grain
+              << std::setw(c2) << merge[c].cutoff
+              << std::setw(c2) << merge[c].grain
+              << '\n';
+    delete [] src;
+    delete [] dst;
+  }
+
+  header << "  template < >\n"
+         << "  struct TunedPolicy < " << name << " >\n"
+         << "  {\n";
+  TuneWrite(header, "Quick", quick);
+  TuneWrite(header, "Merge", merge);
+  header << "  };\n\n";
+}
+
+int AutoTune (const char* outfile, bool fast)
+{
+  std::ofstream out1(outfile);
+  if (out1.fail())
+  {
+    std::cout << " ** cannot open file " << outfile << " for write\n"
+	      << " ** try again\n";
+    return 0;
+  }
+  size_t threads = fsu::TaskPool::Default().Size();
+
+  out1 << "/*\n"
+       << "    gsort_tune.h\n"
+       << "    generated by \"sortspy.x autotune\" on a host with " << threads << " threads\n"
+       << "\n"
+       << "    TunedPolicy specializations for gsort_policy.h, used when compiled\n"
+       << "    with -DGSORT_TUNED. Regenerate rather than edit.\n"
+       << "*/\n\n"
+       << "#ifndef _GSORT_TUNE_H\n"
+       << "#define _GSORT_TUNE_H\n\n"
+       << "#include <cstdint>\n"
+       << "#include <gsort_policy.h>\n\n"
+       << "namespace fsu\n"
+       << "{\n\n";
+
+  std::cout << "\n Autotune (" << threads << " threads)\n\n"
+            << std::left << std::setw(c2) << " type"
+            << std::setw(c2) << "class"
+            << std::right << std::setw(c2) << "size"
+            << std::setw(c2) << "q.cutoff"
+            << std::setw(c3) << "q.pivot"
+            << std::setw(c2) << "q.grain"
+            << std::setw(c2) << "m.cutoff"
+            << std::setw(c2) << "m.grain"
+            << '\n';
+  TuneType < uint32_t > ("uint32_t", fast, out1);
+  TuneType < int32_t >  ("int32_t",  fast, out1);
+  TuneType < uint64_t > ("uint64_t", fast, out1);
+  TuneType < float >    ("float",    fast, out1);
+  TuneType < double >   ("double",   fast, out1);
+
+  out1 << "} // namespace fsu\n\n"
+       << "#endif\n";
+  out1.close();
+  std::cout << "\n Results stored in file " << outfile << '\n'
+            << " rebuild with -DGSORT_TUNED to use them\n\n";
+  return 0;
+}
+
 int main(int argc, char* argv[])
 {
   if (argc < 3)
@@ -100,23 +895,62 @@ int main(int argc, char* argv[])
 	      << "     1: input filename (required)\n"
 	      << "     2: output filename (required)\n"
 	      << "     3: \"fast\" (optional) - omits Theta(n^2) sorts\n"
+	      << "     3..: \"text\" or \"binary\" (optional) - input format;\n"
+	      << "          by default it is recognized from the file\n"
+	      << "     3..: \"perf\" (optional) - hardware performance counters\n"
+	      << " ** or, to tune the sorts for this host:\n"
+	      << "     1: \"autotune\"\n"
+	      << "     2: header to write, e.g. gsort_tune.h (required)\n"
+	      << "     3: \"fast\" (optional) - smaller and shorter trials\n"
+	      << " ** or, to benchmark with repetitions on generated data:\n"
+	      << "     1: \"bench\"\n"
+	      << "     2: results file, CSV or (named *.json) JSON (required)\n"
+	      << "     3..: sizes=1000,10000,... shapes=uniform,sorted,...|all reps=11\n"
+	      << "          warmup=2 seed=1 only=<name part> label=<text> quadratic=20000 fast perf\n"
 	      << " ** try again\n";
     return 0;
   }
 
+  if (std::strcmp(argv[1], "autotune") == 0)
+    return AutoTune(argv[2], argc > 3);
+  if (std::strcmp(argv[1], "bench") == 0)
+    return Bench(argc, argv);
+
   char* infile      = argv[1];
   char* outfile     = argv[2];
-  fsu::LessThanSpy < ElementType > lts;
+  bool  fast        = 0;
+  bool  counters    = 0;
+  fsu::NumberFormat format = fsu::format_auto;
+  for (int i = 3; i < argc; ++i)
+  {
+    if      (std::strcmp(argv[i], "fast") == 0)   fast   = 1;
+    else if (std::strcmp(argv[i], "perf") == 0)   counters = 1;
+    else if (std::strcmp(argv[i], "text") == 0)   format = fsu::format_text;
+    else if (std::strcmp(argv[i], "binary") == 0) format = fsu::format_binary;
+    else
+    {
+      std::cout << " ** unknown option " << argv[i] << '\n'
+		<< " ** try again\n";
+      return 0;
+    }
+  }
   fsu::LessThan    < ElementType > lt;
-  // fsu::GreaterThanSpy < ElementType > lts;
   // fsu::GreaterThan    < ElementType > lt;
-  std::ifstream in1(infile);
-  if (in1.fail())
+
+  // stopwatch
+  fsu::Instant instant, instant1, instant2;
+  fsu::Timer timer;
+
+  // the input, mapped (binary) or parsed (text): never copied through a stream
+  fsu::NumberFile < ElementType > dataStore;
+  timer.SplitReset();
+  if (!dataStore.Open(infile, format))
   {
-    std::cout << " ** cannot open file " << infile << " for read\n"
+    std::cout << " ** " << dataStore.Error() << '\n'
 	      << " ** try again\n";
     return 0;
   }
+  fsu::Instant readInstant = timer.SplitTime();
 
   std::ofstream out1(outfile);
   if (out1.fail())
@@ -126,16 +960,10 @@ int main(int argc, char* argv[])
     return 0;
   }
 
-  fsu::Vector < ElementType >   dataStore;
   fsu::List   < ElementType >   dataList;
   fsu::PushBackIterator < fsu::List < ElementType > > listBackPusher(dataList);
   size_t error_count = 0;
 
-  ElementType item;
-  while (in1 >> item)
-    dataStore.PushBack(item);
-  in1.clear();
-  in1.close();
   if (dataStore.Size() > UINT_MAX)
   {
     std::cout << " ** WARNING: too many items, keep count <= " << UINT_MAX << '\n';
@@ -148,12 +976,23 @@ int main(int argc, char* argv[])
   // this is where we will run the comparison sorts:
   ElementType * data = new ElementType [size];
 
-  // stopwatch
-  fsu::Instant instant, instant1, instant2;
-  fsu::Timer timer;
+  // hardware counters, if asked for and the host has any
+  fsu::PerfCounters perfCounters;
+  fsu::PerfCounters* perf = 0;
+  if (counters)
+  {
+    if (perfCounters.Open())
+      perf = &perfCounters;
+    if (!perfCounters.Error().empty())
+      std::cout << " ** counters: " << perfCounters.Error()
+                << (perf ? "; those missing show as -\n" : "; running without them\n");
+  }
+  const char* formatName = (dataStore.Format() == fsu::format_binary) ? "binary (mapped)" : "text";
 
   std::cout << "\n Input file name: " << infile << '\n'
 	    << "            size: " << size << '\n'
+	    << "          format: " << formatName << '\n'
+	    << "       read usec: " << readInstant.Get_useconds() << '\n'
             << '\n';
   for (size_t i = 0; i < c1+c2+c3+c4+c5+c6; ++i) std::cout << '='; std::cout << '\n';
   std::cout << "Comparison Sorts\n";
@@ -161,22 +1000,28 @@ int main(int argc, char* argv[])
   std::cout << std::left << std::setw(c1) << " algorithm"
             << std::right << std::setw(c2) << "errors"
             << std::setw(c3) << "comp_count" 
-            // << std::setw(c4) << "usec(spy)"
-	    << std::setw(c4+c5) << "usec"
-            << std::setw(c6) << "sec"
-            << '\n'
-            << std::left << std::setw(c1) << " ---------------"
+            << std::setw(c3) << "moves"
+            << std::setw(c3) << "swaps"
+            << std::setw(c4) << "depth"
+	    << std::setw(c5) << "usec"
+            << std::setw(c6) << "sec";
+  PerfHeads(std::cout, perf, 0);
+  std::cout << std::left << std::setw(c1) << " ---------------"
             << std::right << std::setw(c2) << "------"
             << std::setw(c3) << "----------" 
-            // << std::setw(c4) << "----------"
-            << std::setw(c4+c5) << "----------"
-            << std::setw(c6) << "----------"
-            << '\n';
+            << std::setw(c3) << "----------"
+            << std::setw(c3) << "----------"
+            << std::setw(c4) << "-----"
+            << std::setw(c5) << "----------"
+            << std::setw(c6) << "----------";
+  PerfHeads(std::cout, perf, 1);
   out1      << "\n -"
 	    << infile
 	    << "----------------------------------------------\n\n"
 	    << " Input file name: " << infile << '\n'
 	    << "            size: " << size << '\n'
+	    << "          format: " << formatName << '\n'
+	    << "       read usec: " << readInstant.Get_useconds() << '\n'
             << '\n';
   for (size_t i = 0; i < c1+c2+c3+c4+c5+c6; ++i) out1 << '='; out1 << '\n';
   out1      << "Comparison Sorts\n";
@@ -184,534 +1029,126 @@ int main(int argc, char* argv[])
   out1      << std::left << std::setw(c1) << " algorithm"
             << std::right << std::setw(c2) << "errors"
             << std::setw(c3) << "comp_count" 
-            // << std::setw(c4) << "usec(spy)"
-	    << std::setw(c4+c5) << "usec"
-            << std::setw(c6) << "sec"
-            << '\n'
-            << std::left << std::setw(c1) << " ---------------"
+            << std::setw(c3) << "moves"
+            << std::setw(c3) << "swaps"
+            << std::setw(c4) << "depth"
+	    << std::setw(c5) << "usec"
+            << std::setw(c6) << "sec";
+  PerfHeads(out1, perf, 0);
+  out1      << std::left << std::setw(c1) << " ---------------"
             << std::right << std::setw(c2) << "------"
             << std::setw(c3) << "----------" 
-            // << std::setw(c4) << "----------"
-            << std::setw(c4+c5) << "----------"
-            << std::setw(c6) << "----------"
-            << '\n';
+            << std::setw(c3) << "----------"
+            << std::setw(c3) << "----------"
+            << std::setw(c4) << "-----"
+            << std::setw(c5) << "----------"
+            << std::setw(c6) << "----------";
+  PerfHeads(out1, perf, 1);
 
   std::cout << std::fixed << std::setprecision(6) << std::showpoint;
   out1      << std::fixed << std::setprecision(6) << std::showpoint;
 
-  // selection sort
-  if (argc < 4)
-  {
-  fsu::g_copy (dataStore.Begin(), dataStore.End(), data);
-  lts.Reset();
-  timer.SplitReset();
-  fsu::g_selection_sort(data , data + dataStore.Size(), lts);
-  instant1 = timer.SplitTime();
-  error_count = 0;
-  error_count = CheckOrder(data,data+size,lt,0);
-  fsu::g_copy (dataStore.Begin(), dataStore.End(), data);
-  timer.SplitReset();
-  fsu::g_selection_sort(data , data + dataStore.Size(), lt);
-  instant2 = timer.SplitTime();
-  //  error_count = 0;
-  error_count += CheckOrder(data,data+size,lt,0);
-  std::cout << std::left << std::setw(c1) << " g_selection_sort"
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << lts.Count()
-            // << std::setw(c4) << instant1.Get_useconds()
-            << std::setw(c4+c5) << instant2.Get_useconds()
-            << std::setw(c6) << instant2.Get_seconds()
-            << '\n';
-  out1      << std::left << std::setw(c1) << " g_selection_sort"
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << lts.Count()
-            // << std::setw(c4) << instant1.Get_useconds()
-            << std::setw(c4+c5) << instant2.Get_useconds()
-            << std::setw(c6) << instant2.Get_seconds()
-            << '\n';
-  }
+  // the registered sorts (see RegisterSorts)
+  Registry sorts;
+  RegisterSorts(sorts);
+  std::vector < fsu::Instant > times(sorts.Size());
+  TableRows(sorts, { "comparison", "partition", "parallel", "adaptive" },
+            dataStore.Begin(), data, size, fast, times, perf, out1);
   // */
 
-  // insertion sort
-  if (argc < 4)
-  {
-  fsu::g_copy (dataStore.Begin(), dataStore.End(), data);
-  lts.Reset();
+  // records: the same keys in 256-byte elements (up to recordMax of them)
+  size_t recordCount = (size < recordMax) ? size : recordMax;
+  Record * records = new Record [recordCount];
+  fsu::LessThan < Record > ltr;
+  for (size_t i = 0; i < recordCount; ++i)
+    records[i].key = dataStore[i];
   timer.SplitReset();
-  fsu::g_insertion_sort(data , data + dataStore.Size(), lts);
+  fsu::g_intro_sort(records, records + recordCount, ltr);
   instant1 = timer.SplitTime();
-  error_count = 0;
-  error_count = CheckOrder(data,data+size,lt,0);
-  fsu::g_copy (dataStore.Begin(), dataStore.End(), data);
+  error_count = CheckOrder(records,records+recordCount,ltr,0);
+  TableRow(std::cout, "g_intro_sort rec", std::to_string(error_count), 0, instant1);
+  TableRow(out1,      "g_intro_sort rec", std::to_string(error_count), 0, instant1);
+  for (size_t i = 0; i < recordCount; ++i)
+    records[i].key = dataStore[i];
   timer.SplitReset();
-  fsu::g_insertion_sort(data , data + dataStore.Size(), lt);
+  fsu::g_sort_by_key(records, records + recordCount, RecordKey());
   instant2 = timer.SplitTime();
-  error_count += CheckOrder(data,data+size,lt,0);
-  std::cout << std::left << std::setw(c1) << " g_insertion_sort"
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << lts.Count()
-            // << std::setw(c4) << instant1.Get_useconds()
-            << std::setw(c4+c5) << instant2.Get_useconds()
-            << std::setw(c6) << instant2.Get_seconds()
-            << '\n';
-  out1      << std::left << std::setw(c1) << " g_insertion_sort"
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << lts.Count()
-            // << std::setw(c4) << instant1.Get_useconds()
-            << std::setw(c4+c5) << instant2.Get_useconds()
-            << std::setw(c6) << instant2.Get_seconds()
-            << '\n';
+  error_count = CheckOrder(records,records+recordCount,ltr,0);
+  TableRow(std::cout, "g_sort_by_key rec", std::to_string(error_count), 0, instant2);
+  TableRow(out1,      "g_sort_by_key rec", std::to_string(error_count), 0, instant2);
+  if (instant2.Get_seconds() > 0)
+  {
+    std::cout << "   " << recordCount << " records of " << sizeof(Record) << " bytes; speedup: "
+              << std::setprecision(2) << instant1.Get_seconds() / instant2.Get_seconds()
+              << '\n' << std::setprecision(6);
+    out1      << "   " << recordCount << " records of " << sizeof(Record) << " bytes; speedup: "
+              << std::setprecision(2) << instant1.Get_seconds() / instant2.Get_seconds()
+              << '\n' << std::setprecision(6);
   }
+  delete [] records;
   // */
 
-  // quick sort
-  fsu::g_copy (dataStore.Begin(), dataStore.End(), data);
-  lts.Reset();
-  timer.SplitReset();
-  fsu::g_quick_sort(data , data + dataStore.Size(), lts);
-  instant1 = timer.SplitTime();
-  error_count = 0;
-  error_count = CheckOrder(data,data+size,lt,0);
-  fsu::g_copy (dataStore.Begin(), dataStore.End(), data);
-  timer.SplitReset();
-  fsu::g_quick_sort(data , data + dataStore.Size(), lt);
-  instant2 = timer.SplitTime();
-  error_count += CheckOrder(data,data+size,lt,0);
-  std::cout << std::left << std::setw(c1) << " g_quick_sort"
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << lts.Count()
-            // << std::setw(c4) << instant1.Get_useconds()
-            << std::setw(c4+c5) << instant2.Get_useconds()
-            << std::setw(c6) << instant2.Get_seconds()
-            << '\n';
-  out1      << std::left << std::setw(c1) << " g_quick_sort"
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << lts.Count()
-            // << std::setw(c4) << instant1.Get_useconds()
-            << std::setw(c4+c5) << instant2.Get_useconds()
-            << std::setw(c6) << instant2.Get_seconds()
-            << '\n';
-  // */
-
-  /* // quick sort (randomized)
-  fsu::g_copy (dataStore.Begin(), dataStore.End(), data);
-  lts.Reset();
-  timer.SplitReset();
-  fsu::g_random_shuffle(data, data + dataStore.Size());
-  fsu::g_quick_sort(data , data + dataStore.Size(), lts);
-  instant1 = timer.SplitTime();
-  error_count = 0;
-  error_count = CheckOrder(data,data+size,lt,0);
-  fsu::g_copy (dataStore.Begin(), dataStore.End(), data);
-  timer.SplitReset();
-  fsu::g_random_shuffle(data, data + dataStore.Size());
-  fsu::g_quick_sort(data , data + dataStore.Size(), lt);
-  instant2 = timer.SplitTime();
-  error_count += CheckOrder(data,data+size,lt,0);
-  std::cout << std::left << std::setw(c1) << " g_quick_sort_ran"
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << lts.Count()
-            // << std::setw(c4) << instant1.Get_useconds()
-            << std::setw(c4+c5) << instant2.Get_useconds()
-            << std::setw(c6) << instant2.Get_seconds()
-            << '\n';
-  out1      << std::left << std::setw(c1) << " g_quick_sort_ran"
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << lts.Count()
-            // << std::setw(c4) << instant1.Get_useconds()
-            << std::setw(c4+c5) << instant2.Get_useconds()
-            << std::setw(c6) << instant2.Get_seconds()
-            << '\n';
-  // */
-
-  // quick sort (opt)
-  fsu::g_copy (dataStore.Begin(), dataStore.End(), data);
-  lts.Reset();
-  timer.SplitReset();
-  fsu::g_quick_sort_opt(data , data + dataStore.Size(), lts);
-  instant1 = timer.SplitTime();
-  error_count = 0;
-  error_count = CheckOrder(data,data+size,lt,0);
-  fsu::g_copy (dataStore.Begin(), dataStore.End(), data);
-  timer.SplitReset();
-  fsu::g_quick_sort_opt(data , data + dataStore.Size(), lt);
-  instant2 = timer.SplitTime();
-  error_count += CheckOrder(data,data+size,lt,0);
-  std::cout << std::left << std::setw(c1) << " g_quick_sort_opt"
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << lts.Count()
-            // << std::setw(c4) << instant1.Get_useconds()
-            << std::setw(c4+c5) << instant2.Get_useconds()
-            << std::setw(c6) << instant2.Get_seconds()
-            << '\n';
-  out1      << std::left << std::setw(c1) << " g_quick_sort_opt"
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << lts.Count()
-            // << std::setw(c4) << instant1.Get_useconds()
-            << std::setw(c4+c5) << instant2.Get_useconds()
-            << std::setw(c6) << instant2.Get_seconds()
-            << '\n';
-  // */
-
-  /* // quick sort (opt) (randomized)
-  fsu::g_copy (dataStore.Begin(), dataStore.End(), data);
-  lts.Reset();
-  timer.SplitReset();
-  fsu::g_random_shuffle(data, data + dataStore.Size());
-  fsu::g_quick_sort_opt(data , data + dataStore.Size(), lts);
-  instant1 = timer.SplitTime();
-  error_count = 0;
-  error_count = CheckOrder(data,data+size,lt,0);
-  fsu::g_copy (dataStore.Begin(), dataStore.End(), data);
-  timer.SplitReset();
-  fsu::g_random_shuffle(data, data + dataStore.Size());
-  fsu::g_quick_sort_opt(data , data + dataStore.Size(), lt);
-  instant2 = timer.SplitTime();
-  error_count += CheckOrder(data,data+size,lt,0);
-  std::cout << std::left << std::setw(c1) << " g_quick_sort_opt_ran"
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << lts.Count()
-            // << std::setw(c4) << instant1.Get_useconds()
-            << std::setw(c4+c5) << instant2.Get_useconds()
-            << std::setw(c6) << instant2.Get_seconds()
-            << '\n';
-  out1      << std::left << std::setw(c1) << " g_quick_sort_opt_ran"
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << lts.Count()
-            // << std::setw(c4) << instant1.Get_useconds()
-            << std::setw(c4+c5) << instant2.Get_useconds()
-            << std::setw(c6) << instant2.Get_seconds()
-            << '\n';
-  // */
-
-  // quick sort (3w)
-  fsu::g_copy (dataStore.Begin(), dataStore.End(), data);
-  lts.Reset();
-  timer.SplitReset();
-  fsu::g_quick_sort_3w(data , data + dataStore.Size(), lts);
-  instant1 = timer.SplitTime();
-  error_count = 0;
-  error_count = CheckOrder(data,data+size,lt,0);
-  fsu::g_copy (dataStore.Begin(), dataStore.End(), data);
-  timer.SplitReset();
-  fsu::g_quick_sort_3w(data , data + dataStore.Size(), lt);
-  instant2 = timer.SplitTime();
-  error_count += CheckOrder(data,data+size,lt,0);
-  std::cout << std::left << std::setw(c1) << " g_quick_sort_3w    "
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << lts.Count()
-            // << std::setw(c4) << instant1.Get_useconds()
-            << std::setw(c4+c5) << instant2.Get_useconds()
-            << std::setw(c6) << instant2.Get_seconds()
-            << '\n';
-  out1      << std::left << std::setw(c1) << " g_quick_sort_3w    "
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << lts.Count()
-            // << std::setw(c4) << instant1.Get_useconds()
-            << std::setw(c4+c5) << instant2.Get_useconds()
-            << std::setw(c6) << instant2.Get_seconds()
-            << '\n';
-  // */
-
-  /* // quick sort (3w) (randomized)
-  fsu::g_copy (dataStore.Begin(), dataStore.End(), data);
-  lts.Reset();
-  timer.SplitReset();
-  fsu::g_random_shuffle(data, data + dataStore.Size());
-  fsu::g_quick_sort_3w(data , data + dataStore.Size(), lts);
-  instant1 = timer.SplitTime();
-  error_count = 0;
-  error_count = CheckOrder(data,data+size,lt,0);
-  fsu::g_copy (dataStore.Begin(), dataStore.End(), data);
-  timer.SplitReset();
-  fsu::g_random_shuffle(data, data + dataStore.Size());
-  fsu::g_quick_sort_3w(data , data + dataStore.Size(), lt);
-  instant2 = timer.SplitTime();
-  error_count += CheckOrder(data,data+size,lt,0);
-  std::cout << std::left << std::setw(c1) << " g_quick_sort_3w_ran"
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << lts.Count()
-            // << std::setw(c4) << instant1.Get_useconds()
-            << std::setw(c4+c5) << instant2.Get_useconds()
-            << std::setw(c6) << instant2.Get_seconds()
-            << '\n';
-  out1      << std::left << std::setw(c1) << " g_quick_sort_3w_ran"
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << lts.Count()
-            // << std::setw(c4) << instant1.Get_useconds()
-            << std::setw(c4+c5) << instant2.Get_useconds()
-            << std::setw(c6) << instant2.Get_seconds()
-            << '\n';
-  // */
-
-  // quick sort (3w_opt)
-  fsu::g_copy (dataStore.Begin(), dataStore.End(), data);
-  lts.Reset();
-  timer.SplitReset();
-  fsu::g_quick_sort_3w_opt(data , data + dataStore.Size(), lts);
-  instant1 = timer.SplitTime();
-  error_count = 0;
-  error_count = CheckOrder(data,data+size,lt,0);
-  fsu::g_copy (dataStore.Begin(), dataStore.End(), data);
-  timer.SplitReset();
-  fsu::g_quick_sort_3w_opt(data , data + dataStore.Size(), lt);
-  instant2 = timer.SplitTime();
-  error_count += CheckOrder(data,data+size,lt,0);
-  std::cout << std::left << std::setw(c1) << " g_quick_sort_3w_opt"
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << lts.Count()
-            // << std::setw(c4) << instant1.Get_useconds()
-            << std::setw(c4+c5) << instant2.Get_useconds()
-            << std::setw(c6) << instant2.Get_seconds()
-            << '\n';
-  out1      << std::left << std::setw(c1) << " g_quick_sort_3w_opt"
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << lts.Count()
-            // << std::setw(c4) << instant1.Get_useconds()
-            << std::setw(c4+c5) << instant2.Get_useconds()
-            << std::setw(c6) << instant2.Get_seconds()
-            << '\n';
-  // */
-
-  /* // quick sort (3w_opt) (randomized)
-  fsu::g_copy (dataStore.Begin(), dataStore.End(), data);
-  lts.Reset();
-  timer.SplitReset();
-  fsu::g_random_shuffle(data, data + dataStore.Size());
-  fsu::g_quick_sort_3w_opt(data , data + dataStore.Size(), lts);
-  instant1 = timer.SplitTime();
-  error_count = 0;
-  error_count = CheckOrder(data,data+size,lt,0);
-  fsu::g_copy (dataStore.Begin(), dataStore.End(), data);
-  timer.SplitReset();
-  fsu::g_random_shuffle(data, data + dataStore.Size());
-  fsu::g_quick_sort_3w_opt(data , data + dataStore.Size(), lt);
-  instant2 = timer.SplitTime();
-  error_count += CheckOrder(data,data+size,lt,0);
-  std::cout << std::left << std::setw(c1) << " g_quick_sort_3w_opt_ran"
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << lts.Count()
-            // << std::setw(c4) << instant1.Get_useconds()
-            << std::setw(c4+c5) << instant2.Get_useconds()
-            << std::setw(c6) << instant2.Get_seconds()
-            << '\n';
-  out1      << std::left << std::setw(c1) << " g_quick_sort_3w_opt_ran"
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << lts.Count()
-            // << std::setw(c4) << instant1.Get_useconds()
-            << std::setw(c4+c5) << instant2.Get_useconds()
-            << std::setw(c6) << instant2.Get_seconds()
-            << '\n';
-  // */
-
-  // merge sort (rec)
-  fsu::g_copy (dataStore.Begin(), dataStore.End(), data);
-  lts.Reset();
-  timer.SplitReset();
-  fsu::g_merge_sort(data , data + dataStore.Size(), lts);
-  instant1 = timer.SplitTime();
-  error_count = 0;
-  error_count = CheckOrder(data,data+size,lt,0);
-  fsu::g_copy (dataStore.Begin(), dataStore.End(), data);
-  timer.SplitReset();
-  fsu::g_merge_sort(data , data + dataStore.Size(), lt);
-  instant2 = timer.SplitTime();
-  error_count += CheckOrder(data,data+size,lt,0);
-  std::cout << std::left << std::setw(c1) << " g_merge_sort       "
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << lts.Count()
-            // << std::setw(c4) << instant1.Get_useconds()
-            << std::setw(c4+c5) << instant2.Get_useconds()
-            << std::setw(c6) << instant2.Get_seconds()
-            << '\n';
-  out1      << std::left << std::setw(c1) << " g_merge_sort       "
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << lts.Count()
-            // << std::setw(c4) << instant1.Get_useconds()
-            << std::setw(c4+c5) << instant2.Get_useconds()
-            << std::setw(c6) << instant2.Get_seconds()
-            << '\n';
-  // */
-
-  // merge sort (opt)
-  fsu::g_copy (dataStore.Begin(), dataStore.End(), data);
-  lts.Reset();
-  timer.SplitReset();
-  fsu::g_merge_sort_opt(data , data + dataStore.Size(), lts);
-  instant1 = timer.SplitTime();
-  error_count = 0;
-  error_count = CheckOrder(data,data+size,lt,0);
-  fsu::g_copy (dataStore.Begin(), dataStore.End(), data);
-  timer.SplitReset();
-  fsu::g_merge_sort_opt(data , data + dataStore.Size(), lt);
-  instant2 = timer.SplitTime();
-  error_count += CheckOrder(data,data+size,lt,0);
-  std::cout << std::left << std::setw(c1) << " g_merge_sort_opt   "
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << lts.Count()
-            // << std::setw(c4) << instant1.Get_useconds()
-            << std::setw(c4+c5) << instant2.Get_useconds()
-            << std::setw(c6) << instant2.Get_seconds()
-            << '\n';
-  out1      << std::left << std::setw(c1) << " g_merge_sort_opt   "
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << lts.Count()
-            // << std::setw(c4) << instant1.Get_useconds()
-            << std::setw(c4+c5) << instant2.Get_useconds()
-            << std::setw(c6) << instant2.Get_seconds()
-            << '\n';
-  // */
-
-  // merge sort (bu)
-  fsu::g_copy (dataStore.Begin(), dataStore.End(), data);
-  lts.Reset();
-  timer.SplitReset();
-  fsu::g_merge_sort_bu(data , data + dataStore.Size(), lts);
-  instant1 = timer.SplitTime();
-  error_count = 0;
-  error_count = CheckOrder(data,data+size,lt,0);
-  fsu::g_copy (dataStore.Begin(), dataStore.End(), data);
-  timer.SplitReset();
-  fsu::g_merge_sort_bu(data , data + dataStore.Size(), lt);
-  instant2 = timer.SplitTime();
-  error_count += CheckOrder(data,data+size,lt,0);
-  std::cout << std::left << std::setw(c1) << " g_merge_sort_bu    "
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << lts.Count()
-            // << std::setw(c4) << instant1.Get_useconds()
-            << std::setw(c4+c5) << instant2.Get_useconds()
-            << std::setw(c6) << instant2.Get_seconds()
-            << '\n';
-  out1      << std::left << std::setw(c1) << " g_merge_sort_bu    "
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << lts.Count()
-            // << std::setw(c4) << instant1.Get_useconds()
-            << std::setw(c4+c5) << instant2.Get_useconds()
-            << std::setw(c6) << instant2.Get_seconds()
-            << '\n';
+  // strings: the same keys as 32-character strings (too long to be stored
+  // inside std::string, so every copy allocates), up to stringMax of them
+  {
+    size_t stringCount = (size < stringMax) ? size : stringMax;
+    std::string * strings  = new std::string [stringCount];
+    std::string * sdata    = new std::string [stringCount];
+    CopyString  * cstrings = new CopyString [stringCount];
+    CopyString  * cdata    = new CopyString [stringCount];
+    char key [40];
+    for (size_t i = 0; i < stringCount; ++i)
+    {
+      std::snprintf(key, sizeof(key), "key-%010u-%017u", (unsigned)dataStore[i], (unsigned)i);
+      strings[i] = key;
+      cstrings[i].s = key;
+    }
+    std::cout << "   " << stringCount << " strings of 32 characters; str = std::string, cstr = copy only\n";
+    out1      << "   " << stringCount << " strings of 32 characters; str = std::string, cstr = copy only\n";
+    fsu::Instant moved, copied;
+    moved  = StringRow("g_intro_sort str", strings, sdata, stringCount,
+                       [](std::string* b, std::string* e) { fsu::g_intro_sort(b, e); }, out1);
+    copied = StringRow("g_intro_sort cstr", cstrings, cdata, stringCount,
+                       [](CopyString* b, CopyString* e) { fsu::g_intro_sort(b, e); }, out1);
+    StringSpeedup(moved, copied, out1);
+    moved  = StringRow("g_merge_sort str", strings, sdata, stringCount,
+                       [](std::string* b, std::string* e) { fsu::g_merge_sort(b, e); }, out1);
+    copied = StringRow("g_merge_sort cstr", cstrings, cdata, stringCount,
+                       [](CopyString* b, CopyString* e) { fsu::g_merge_sort(b, e); }, out1);
+    StringSpeedup(moved, copied, out1);
+    moved  = StringRow("g_heap_sort str", strings, sdata, stringCount,
+                       [](std::string* b, std::string* e) { fsu::g_heap_sort(b, e); }, out1);
+    copied = StringRow("g_heap_sort cstr", cstrings, cdata, stringCount,
+                       [](CopyString* b, CopyString* e) { fsu::g_heap_sort(b, e); }, out1);
+    StringSpeedup(moved, copied, out1);
+    delete [] strings;
+    delete [] sdata;
+    delete [] cstrings;
+    delete [] cdata;
+  }
   // */
 
-  // list sort (in-place merge sort)
+  // list sort (in-place merge sort): relinks, so only comparisons are counted,
+  // in a second, untimed run, as in TableRows
   fsu::g_copy (dataStore.Begin(), dataStore.End(), listBackPusher);
-
   timer.SplitReset();
   dataList.Sort(lt);
   instant2 = timer.SplitTime();
-
   dataList.CheckLinks();
-  error_count = 0;
   error_count = CheckOrder(dataList.Begin(),dataList.End(),lt);
-  fsu::g_copy (dataStore.Begin(), dataStore.End(), dataList.Begin());
-  dataList.CheckLinks();
-
-  lts.Reset();
-  timer.SplitReset();
-  dataList.Sort(lts);
-  instant1 = timer.SplitTime();
-
-  dataList.CheckLinks();
-  error_count += CheckOrder(dataList.Begin(),dataList.End(),lt);
-  std::cout << std::left << std::setw(c1) << " List::Sort"
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << lts.Count()
-            // << std::setw(c4) << instant1.Get_useconds()
-            << std::setw(c4+c5) << instant2.Get_useconds()
-            << std::setw(c6) << instant2.Get_seconds()
-            << '\n';
-  out1      << std::left << std::setw(c1) << " List::Sort"
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << lts.Count()
-            // << std::setw(c4) << instant1.Get_useconds()
-            << std::setw(c4+c5) << instant2.Get_useconds()
-            << std::setw(c6) << instant2.Get_seconds()
-            << '\n';
-  // */
-
-  // alt::heap sort
-  fsu::g_copy (dataStore.Begin(), dataStore.End(), data);
-  lts.Reset();
-  timer.SplitReset();
-  alt::g_heap_sort(data , data + dataStore.Size(), lts);
-  instant1 = timer.SplitTime();
-  error_count = 0;
-  error_count = CheckOrder(data,data+size,lt,0);
-  fsu::g_copy (dataStore.Begin(), dataStore.End(), data);
-  timer.SplitReset();
-  alt::g_heap_sort(data , data + dataStore.Size(), lt);
-  instant2 = timer.SplitTime();
-  error_count += CheckOrder(data,data+size,lt,0);
-  std::cout << std::left << std::setw(c1) << " alt::g_heap_sort"
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << lts.Count()
-            // << std::setw(c4) << instant1.Get_useconds()
-            << std::setw(c4+c5) << instant2.Get_useconds()
-            << std::setw(c6) << instant2.Get_seconds()
-            << '\n';
-  out1      << std::left << std::setw(c1) << " alt::g_heap_sort"
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << lts.Count()
-            // << std::setw(c4) << instant1.Get_useconds()
-            << std::setw(c4+c5) << instant2.Get_useconds()
-            << std::setw(c6) << instant2.Get_seconds()
-            << '\n';
-  // */
 
-  // fsu::heap sort
-  fsu::g_copy (dataStore.Begin(), dataStore.End(), data);
-  lts.Reset();
-  timer.SplitReset();
-  fsu::g_heap_sort(data , data + dataStore.Size(), lts);
-  instant1 = timer.SplitTime();
-  error_count = 0;
-  error_count = CheckOrder(data,data+size,lt,0);
-  fsu::g_copy (dataStore.Begin(), dataStore.End(), data);
-  timer.SplitReset();
-  fsu::g_heap_sort(data , data + dataStore.Size(), lt);
-  instant2 = timer.SplitTime();
-  error_count += CheckOrder(data,data+size,lt,0);
-  std::cout << std::left << std::setw(c1) << " fsu::g_heap_sort"
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << lts.Count()
-            // << std::setw(c4) << instant1.Get_useconds()
-            << std::setw(c4+c5) << instant2.Get_useconds()
-            << std::setw(c6) << instant2.Get_seconds()
-            << '\n';
-  out1      << std::left << std::setw(c1) << " fsu::g_heap_sort"
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << lts.Count()
-            // << std::setw(c4) << instant1.Get_useconds()
-            << std::setw(c4+c5) << instant2.Get_useconds()
-            << std::setw(c6) << instant2.Get_seconds()
-            << '\n';
+  dataList.Clear();
+  fsu::g_copy (dataStore.Begin(), dataStore.End(), listBackPusher);
+  CountingLessThan ltc;
+  fsu::CountInstrument::Reset();
+  dataList.Sort(ltc);
+  fsu::SortCounters listCounters = fsu::CountInstrument::Total();
+  TableRow(std::cout, "List::Sort", std::to_string(error_count), &listCounters, instant2);
+  TableRow(out1,      "List::Sort", std::to_string(error_count), &listCounters, instant2);
   // */
 
-  // cormen::heap sort
-  fsu::g_copy (dataStore.Begin(), dataStore.End(), data);
-  lts.Reset();
-  timer.SplitReset();
-  cormen::g_heap_sort(data , data + dataStore.Size(), lts);
-  instant1 = timer.SplitTime();
-  error_count = 0;
-  error_count = CheckOrder(data,data+size,lt,0);
-  fsu::g_copy (dataStore.Begin(), dataStore.End(), data);
-  timer.SplitReset();
-  cormen::g_heap_sort(data , data + dataStore.Size(), lt);
-  instant2 = timer.SplitTime();
-  error_count += CheckOrder(data,data+size,lt,0);
-  std::cout << std::left << std::setw(c1) << " cormen::g_heap_sort"
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << lts.Count()
-            // << std::setw(c4) << instant1.Get_useconds()
-            << std::setw(c4+c5) << instant2.Get_useconds()
-            << std::setw(c6) << instant2.Get_seconds()
-            << '\n';
-  out1      << std::left << std::setw(c1) << " cormen::g_heap_sort"
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << lts.Count()
-            // << std::setw(c4) << instant1.Get_useconds()
-            << std::setw(c4+c5) << instant2.Get_useconds()
-            << std::setw(c6) << instant2.Get_seconds()
-            << '\n';
+  // heap sorts
+  TableRows(sorts, { "heap" }, dataStore.Begin(), data, size, fast, times, perf, out1);
   // */
 
   // non-comparison sorts
@@ -751,7 +1188,8 @@ int main(int argc, char* argv[])
             << '\n';
   // */
 
-  // counting sort
+  // counting sort: not registered, since it needs max + 1 counters, which
+  // the data decides
   fsu::g_copy (dataStore.Begin(), dataStore.End(), data);
   timer.SplitReset();
   NumberType max = *(fsu::g_max_element(dataStore.Begin(), dataStore.End()));
@@ -763,20 +1201,10 @@ int main(int argc, char* argv[])
     delete [] B;
     instant = timer.SplitTime();
     error_count = CheckOrder(data,data+size,lt,0);
-    std::cout << std::left  << std::setw(c1) << " counting_sort"
-              << std::right << std::setw(c2) << error_count
-              << std::setw(c3) << " -"
-              << std::setw(c4) << " -"
-              << std::setw(c5) << instant.Get_useconds()
-              << std::setw(c6) << instant.Get_seconds()
-              << '\n';
-    out1      << std::left << std::setw(c1) << " counting_sort"
-              << std::right << std::setw(c2) << error_count
-              << std::setw(c3) << " -"
-              << std::setw(c4) << " -"
-              << std::setw(c5) << instant.Get_useconds()
-              << std::setw(c6) << instant.Get_seconds()
-              << '\n';
+    std::ostringstream loops;
+    loops << std::setw(c3) << " -" << std::setw(c4) << " -";
+    NumericRow(std::cout, "counting_sort", error_count, loops.str(), instant);
+    NumericRow(out1,      "counting_sort", error_count, loops.str(), instant);
   }
   else
   {
@@ -790,261 +1218,18 @@ int main(int argc, char* argv[])
   }
   // */
 
-  // these are used testing bit_sort, byte_sort, and word_sort
-  typedef uint8_t      TinyElementType;    // 1
-  typedef uint16_t     SmallElementType;   // 2
-  typedef uint32_t     MediumElementType;  // 4
-  typedef uint64_t     LargeElementType;   // 8
-
-  // bit sort 8
-  TinyElementType * data8 = new TinyElementType [size];
-  fsu::g_copy (dataStore.Begin(), dataStore.End(), data8); // obvious overflow possibilities
-  timer.SplitReset();
-  size_t loop_count = fsu::bit_sort (data8, size);
-  instant = timer.SplitTime();
-  error_count = CheckOrder(data8,data8+size,lt,0);
-  std::cout << std::left << std::setw(c1) << " bit_sort"
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << "bits"
-            << std::setw(c4) << loop_count
-            << std::setw(c5) << instant.Get_useconds()
-            << std::setw(c6) << instant.Get_seconds()
-            << '\n';
-  out1      << std::left << std::setw(c1) << " bit_sort"
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << "bits"
-            << std::setw(c4) << loop_count
-            << std::setw(c5) << instant.Get_useconds()
-            << std::setw(c6) << instant.Get_seconds()
-            << '\n';
-  // */
-
-  // bit sort 16
-  SmallElementType * data16 = new SmallElementType [size];
-  fsu::g_copy (dataStore.Begin(), dataStore.End(), data16); // obvious overflow possibilities
-  timer.SplitReset();
-  loop_count = fsu::bit_sort (data16, size);
-  instant = timer.SplitTime();
-  error_count = CheckOrder(data16,data16+size,lt,0);
-  std::cout << std::left << std::setw(c1) << " bit_sort"
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << "bits"
-            << std::setw(c4) << loop_count
-            << std::setw(c5) << instant.Get_useconds()
-            << std::setw(c6) << instant.Get_seconds()
-            << '\n';
-  out1      << std::left << std::setw(c1) << " bit_sort"
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << "bits"
-            << std::setw(c4) << loop_count
-            << std::setw(c5) << instant.Get_useconds()
-            << std::setw(c6) << instant.Get_seconds()
-            << '\n';
-  // */
-
-  // bit sort 32
-  fsu::g_copy (dataStore.Begin(), dataStore.End(), data);
-  timer.SplitReset();
-  loop_count = fsu::bit_sort (data, dataStore.Size());
-  instant = timer.SplitTime();
-  error_count = CheckOrder(data,data+size,lt,0);
-  std::cout << std::left << std::setw(c1) << " bit_sort"
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << "bits"
-            << std::setw(c4) << loop_count
-            << std::setw(c5) << instant.Get_useconds()
-            << std::setw(c6) << instant.Get_seconds()
-            << '\n';
-  out1      << std::left << std::setw(c1) << " bit_sort"
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << "bits"
-            << std::setw(c4) << loop_count
-            << std::setw(c5) << instant.Get_useconds()
-            << std::setw(c6) << instant.Get_seconds()
-            << '\n';
-  // */
-
-  // bit sort 64
-  LargeElementType * data64 = new LargeElementType [size];
-  fsu::g_copy (dataStore.Begin(), dataStore.End(), data64);
-  timer.SplitReset();
-  loop_count = fsu::bit_sort (data64, size);
-  instant = timer.SplitTime();
-  error_count = CheckOrder(data64,data64+size,lt,0);
-  std::cout << std::left << std::setw(c1) << " bit_sort"
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << "bits"
-            << std::setw(c4) << loop_count
-            << std::setw(c5) << instant.Get_useconds()
-            << std::setw(c6) << instant.Get_seconds()
-            << '\n';
-  out1      << std::left << std::setw(c1) << " bit_sort"
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << "bits"
-            << std::setw(c4) << loop_count
-            << std::setw(c5) << instant.Get_useconds()
-            << std::setw(c6) << instant.Get_seconds()
-            << '\n';
-  // */
-
-  // byte sort 8
-  fsu::g_copy (dataStore.Begin(), dataStore.End(), data8);
-  timer.SplitReset();
-  loop_count = fsu::byte_sort (data8, size);
-  instant = timer.SplitTime();
-  error_count = CheckOrder(data8,data8+size,lt,0);
-  std::cout << std::left << std::setw(c1) << " byte_sort"
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << "bytes"
-            << std::setw(c4) << loop_count
-            << std::setw(c5) << instant.Get_useconds()
-            << std::setw(c6) << instant.Get_seconds()
-            << '\n';
-  out1      << std::left << std::setw(c1) << " byte_sort"
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << "bytes"
-            << std::setw(c4) << loop_count
-            << std::setw(c5) << instant.Get_useconds()
-            << std::setw(c6) << instant.Get_seconds()
-            << '\n';
-  // */
-
-  // byte sort 16
-  fsu::g_copy (dataStore.Begin(), dataStore.End(), data16);
-  timer.SplitReset();
-  loop_count = fsu::byte_sort (data16, size);
-  instant = timer.SplitTime();
-  error_count = CheckOrder(data16,data16+size,lt,0);
-  std::cout << std::left << std::setw(c1) << " byte_sort"
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << "bytes"
-            << std::setw(c4) << loop_count
-            << std::setw(c5) << instant.Get_useconds()
-            << std::setw(c6) << instant.Get_seconds()
-            << '\n';
-  out1      << std::left << std::setw(c1) << " byte_sort"
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << "bytes"
-            << std::setw(c4) << loop_count
-            << std::setw(c5) << instant.Get_useconds()
-            << std::setw(c6) << instant.Get_seconds()
-            << '\n';
-  // */
-
-  // byte sort 32
-  fsu::g_copy (dataStore.Begin(), dataStore.End(), data);
-  timer.SplitReset();
-  loop_count = fsu::byte_sort (data, dataStore.Size());
-  instant = timer.SplitTime();
-  error_count = CheckOrder(data,data+size,lt,0);
-  std::cout << std::left << std::setw(c1) << " byte_sort"
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << "bytes"
-            << std::setw(c4) << loop_count
-            << std::setw(c5) << instant.Get_useconds()
-            << std::setw(c6) << instant.Get_seconds()
-            << '\n';
-  out1      << std::left << std::setw(c1) << " byte_sort"
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << "bytes"
-            << std::setw(c4) << loop_count
-            << std::setw(c5) << instant.Get_useconds()
-            << std::setw(c6) << instant.Get_seconds()
-            << '\n';
-  // */
-
-  // byte sort 64 
-  fsu::g_copy (dataStore.Begin(), dataStore.End(), data64);
-  timer.SplitReset();
-  loop_count = fsu::byte_sort (data64, dataStore.Size());
-  instant = timer.SplitTime();
-  error_count = CheckOrder(data64,data64+size,lt,0);
-  std::cout << std::left << std::setw(c1) << " byte_sort"
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << "bytes"
-            << std::setw(c4) << loop_count
-            << std::setw(c5) << instant.Get_useconds()
-            << std::setw(c6) << instant.Get_seconds()
-            << '\n';
-  out1      << std::left << std::setw(c1) << " byte_sort"
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << "bytes"
-            << std::setw(c4) << loop_count
-            << std::setw(c5) << instant.Get_useconds()
-            << std::setw(c6) << instant.Get_seconds()
-            << '\n';
-  // */
-
-  // word sort 16
-  fsu::g_copy (dataStore.Begin(), dataStore.End(), data16);
-  timer.SplitReset();
-  loop_count = fsu::word_sort (data16, dataStore.Size());
-  instant = timer.SplitTime();
-  error_count = CheckOrder(data16,data16+size,lt,0);
-  std::cout << std::left << std::setw(c1) << " word_sort"
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << "words"
-            << std::setw(c4) << loop_count
-            << std::setw(c5) << instant.Get_useconds()
-            << std::setw(c6) << instant.Get_seconds()
-            << '\n';
-  out1      << std::left << std::setw(c1) << " word_sort"
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << "words"
-            << std::setw(c4) << loop_count
-            << std::setw(c5) << instant.Get_useconds()
-            << std::setw(c6) << instant.Get_seconds()
-            << '\n';
-  // */
-
-  // word sort 32
-  fsu::g_copy (dataStore.Begin(), dataStore.End(), data);
-  timer.SplitReset();
-  loop_count = fsu::word_sort (data, dataStore.Size());
-  instant = timer.SplitTime();
-  error_count = CheckOrder(data,data+size,lt,0);
-  std::cout << std::left << std::setw(c1) << " word_sort"
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << "words"
-            << std::setw(c4) << loop_count
-            << std::setw(c5) << instant.Get_useconds()
-            << std::setw(c6) << instant.Get_seconds()
-            << '\n';
-  out1      << std::left << std::setw(c1) << " word_sort"
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << "words"
-            << std::setw(c4) << loop_count
-            << std::setw(c5) << instant.Get_useconds()
-            << std::setw(c6) << instant.Get_seconds()
-            << '\n';
-  // */
-
-  // word sort 64
-  fsu::g_copy (dataStore.Begin(), dataStore.End(), data64);
-  timer.SplitReset();
-  loop_count = fsu::word_sort (data64, dataStore.Size());
-  instant = timer.SplitTime();
-  error_count = CheckOrder(data64,data64+size,lt,0);
-  std::cout << std::left << std::setw(c1) << " word_sort"
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << "words"
-            << std::setw(c4) << loop_count
-            << std::setw(c5) << instant.Get_useconds()
-            << std::setw(c6) << instant.Get_seconds()
-            << '\n';
-  out1      << std::left << std::setw(c1) << " word_sort"
-            << std::right << std::setw(c2) << error_count
-            << std::setw(c3) << "words"
-            << std::setw(c4) << loop_count
-            << std::setw(c5) << instant.Get_useconds()
-            << std::setw(c6) << instant.Get_seconds()
-            << '\n';
+  // the registered numeric sorts at 8, 16, 32 and 64 bits (see
+  // RegisterNumericSorts); the 8 and 16 bit copies of the data overflow
+  {
+    NumericRegistries numeric;
+    NumericRows(numeric.w8,  dataStore.Begin(), size, out1);
+    NumericRows(numeric.w16, dataStore.Begin(), size, out1);
+    NumericRows(numeric.w32, dataStore.Begin(), size, out1);
+    NumericRows(numeric.w64, dataStore.Begin(), size, out1);
+  }
   // */
 
   delete [] data;
-  delete [] data8;
-  delete [] data16;
-  delete [] data64;
   instant = timer.EventTime();
   std::cout << '\n'
             << std::left << std::setw(c1) << " Total Time:"
@@ -0,0 +1,112 @@
+/*
+    topk.h
+    10/19/26
+
+    a top-k accumulator: the k first elements of a stream, in O(k) space
+
+      fsu::TopK < Record , ByScore > best(10);   // the 10 that come first by ByScore
+      while (is >> r) best.Push(r);              // any number of elements
+      std::vector < Record > v; best.Sorted(v);  // the 10, in order
+
+    The k kept are those g_partial_sort(beg, beg + k, end, pred) would leave
+    in front if the whole stream were in one range: the least k by P, or,
+    with GreaterThan, the greatest. They are kept in a POT by P (gheap.h),
+    so the top is Bound(), the last of them in the order. Each element
+    pushed is compared with that once; one that comes before it replaces it
+    and the top is repaired, O(log k). A stream of n costs O(n log k) in
+    all and never holds more than k elements, and on random data only
+    about k ln(n/k) of them get past the comparison with Bound().
+
+    Bound() is also the cut-off a producer may test itself, to skip work on
+    elements that cannot make it in, once Full().
+*/
+
+#ifndef _TOPK_H
+#define _TOPK_H
+
+#include <cstdlib>   // size_t
+#include <vector>
+#include <utility>   // std::move
+#include <compare.h>
+#include <gheap.h>
+
+namespace fsu
+{
+
+  template < typename T , class P = LessThan<T> >
+  class TopK
+  {
+  public:
+    explicit TopK (size_t k, const P& pred = P()) : k_(k), pred_(pred) { items_.reserve(k); }
+
+    bool     Push   (const T& t);  // true if t is kept, for now
+    bool     Push   (T&& t);
+    const T& Bound  () const;      // Pre: !Empty(); the last kept, in the order
+    void     Sorted (std::vector<T>& v) const; // the kept, in order
+
+    size_t   Size   () const { return items_.size(); }
+    size_t   K      () const { return k_; }
+    bool     Empty  () const { return items_.empty(); }
+    bool     Full   () const { return items_.size() == k_; }
+    void     Clear  () { items_.clear(); }
+
+  private:
+    template < typename U >
+    bool PushAny (U&& t);
+
+    size_t         k_;
+    std::vector<T> items_; // a POT by pred_, at most k_ long
+    mutable P      pred_;
+  };
+
+  //-------------------------------------
+  // TopK <T,P>
+  //-------------------------------------
+
+  template < typename T , class P >
+  bool TopK<T,P>::Push (const T& t)
+  {
+    return PushAny(t);
+  }
+
+  template < typename T , class P >
+  bool TopK<T,P>::Push (T&& t)
+  {
+    return PushAny(std::move(t));
+  }
+
+  template < typename T , class P >
+  template < typename U >
+  bool TopK<T,P>::PushAny (U&& t)
+  {
+    if (items_.size() < k_)
+    {
+      items_.push_back(std::forward<U>(t));
+      g_push_heap(items_.begin(), items_.end(), pred_);
+      return 1;
+    }
+    if (k_ == 0 || !pred_(t, items_[0]))
+      return 0;
+    items_[0] = std::forward<U>(t); // the old top is out
+    g_heap_repair(items_.begin(), items_.begin(), items_.end(), pred_);
+    return 1;
+  }
+
+  template < typename T , class P >
+  const T& TopK<T,P>::Bound () const
+  {
+    return items_[0];
+  }
+
+  template < typename T , class P >
+  void TopK<T,P>::Sorted (std::vector<T>& v) const
+  // the second stage of g_heap_sort, on a copy
+  {
+    v = items_;
+    for (size_t i = v.size(); i > 1; --i)
+      g_pop_heap(v.begin(), v.begin() + i, pred_);
+  }
+
+} // namespace fsu
+
+#endif
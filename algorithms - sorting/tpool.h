@@ -0,0 +1,257 @@
+/*
+    tpool.h
+    10/19/26
+
+    a small fork-join thread pool for the parallel sorts
+
+      TaskPool  - a fixed set of worker threads with work-stealing deques
+      TaskGroup - tasks spawned together and waited for together
+
+    Each worker owns a deque. A task spawned from inside a worker goes on
+    the back of that worker's deque, and the worker takes its own work back
+    newest first (the smallest, most cache-warm pieces of a recursion). An
+    idle worker steals from the front of another worker's deque, which is
+    where the oldest and largest pieces are. Tasks submitted from outside
+    the pool go through a shared queue.
+
+    A thread waiting on a TaskGroup does not block: it runs queued tasks
+    until its own group is finished. That is what lets recursive algorithms
+    fork at every level without running out of workers.
+
+    Tasks must not throw.
+
+    usage:
+
+      fsu::TaskGroup g(fsu::TaskPool::Default());
+      g.Spawn(left_half);
+      right_half();
+      g.Wait();
+*/
+
+#ifndef _TPOOL_H
+#define _TPOOL_H
+
+#include <cstdlib>   // size_t
+#include <deque>
+#include <vector>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+namespace fsu
+{
+
+  class TaskPool
+  {
+  public:
+    typedef std::function<void()> Task;
+
+    explicit TaskPool (size_t threads = 0); // 0 means one per hardware thread
+    ~TaskPool ();
+
+    size_t Size   () const { return workers_.size(); }
+    void   Submit (const Task& task);
+    bool   RunOne (); // runs one queued task in the calling thread, if there is one
+
+    static TaskPool& Default (); // process-wide pool, started on first use
+
+  private:
+    struct Deque
+    {
+      std::deque<Task> tasks;
+      std::mutex       mutex;
+    };
+
+    void   Work    (size_t self);
+    bool   Take    (Task& task);   // own deque, then shared queue, then steal
+    bool   PopBack (Deque& d, Task& task);
+    bool   PopFront(Deque& d, Task& task);
+    size_t Self    () const;       // index of the calling worker, or Size() if not one
+
+    TaskPool (const TaskPool&);             // disallowed
+    TaskPool& operator = (const TaskPool&); // disallowed
+
+    std::vector<std::thread> workers_;
+    std::vector<Deque*>      deques_;  // one per worker
+    Deque                    shared_;  // tasks from threads outside the pool
+    std::atomic<size_t>      queued_;  // tasks in all deques
+    std::atomic<size_t>      sleepers_;
+    std::mutex               mutex_;   // guards sleeping and stop_
+    std::condition_variable  ready_;
+    bool                     stop_;
+
+    // which pool, and which worker in it, the calling thread is
+    static TaskPool*& ThisPool   () { static thread_local TaskPool* p = 0; return p; }
+    static size_t&    ThisWorker () { static thread_local size_t    i = 0; return i; }
+  };
+
+  class TaskGroup
+  {
+  public:
+    explicit TaskGroup (TaskPool& pool) : pool_(pool), pending_(0) {}
+    ~TaskGroup () { Wait(); }
+
+    void Spawn (const TaskPool::Task& task);
+    void Wait  ();
+
+  private:
+    TaskGroup (const TaskGroup&);             // disallowed
+    TaskGroup& operator = (const TaskGroup&); // disallowed
+
+    TaskPool&           pool_;
+    std::atomic<size_t> pending_;
+  };
+
+  //----------------------------------
+  //     TaskPool
+  //----------------------------------
+
+  inline TaskPool::TaskPool (size_t threads) : queued_(0), sleepers_(0), stop_(0)
+  {
+    if (threads == 0)
+      threads = std::thread::hardware_concurrency();
+    if (threads == 0)
+      threads = 1;
+    for (size_t i = 0; i < threads; ++i)
+      deques_.push_back(new Deque);
+    for (size_t i = 0; i < threads; ++i)
+      workers_.push_back(std::thread(&TaskPool::Work, this, i));
+  }
+
+  inline TaskPool::~TaskPool ()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stop_ = 1;
+    }
+    ready_.notify_all();
+    for (size_t i = 0; i < workers_.size(); ++i)
+      workers_[i].join();
+    for (size_t i = 0; i < deques_.size(); ++i)
+      delete deques_[i];
+  }
+
+  inline size_t TaskPool::Self () const
+  {
+    return (ThisPool() == this) ? ThisWorker() : workers_.size();
+  }
+
+  inline void TaskPool::Submit (const Task& task)
+  {
+    size_t self = Self();
+    Deque& d = (self < deques_.size()) ? *deques_[self] : shared_;
+    {
+      std::lock_guard<std::mutex> lock(d.mutex);
+      ++queued_;
+      d.tasks.push_back(task);
+    }
+    if (sleepers_ != 0)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      ready_.notify_one();
+    }
+  }
+
+  inline bool TaskPool::PopBack (Deque& d, Task& task)
+  {
+    std::lock_guard<std::mutex> lock(d.mutex);
+    if (d.tasks.empty())
+      return 0;
+    task = d.tasks.back();
+    d.tasks.pop_back();
+    --queued_;
+    return 1;
+  }
+
+  inline bool TaskPool::PopFront (Deque& d, Task& task)
+  {
+    std::lock_guard<std::mutex> lock(d.mutex);
+    if (d.tasks.empty())
+      return 0;
+    task = d.tasks.front();
+    d.tasks.pop_front();
+    --queued_;
+    return 1;
+  }
+
+  inline bool TaskPool::Take (Task& task)
+  {
+    if (queued_ == 0)
+      return 0;
+    size_t n = deques_.size(), self = Self();
+    if (self < n && PopBack(*deques_[self], task))
+      return 1;
+    if (PopFront(shared_, task))
+      return 1;
+    // steal, starting just past ourselves so thieves spread out
+    for (size_t k = 1; k <= n; ++k)
+    {
+      size_t victim = (self + k) % n;
+      if (victim != self && PopFront(*deques_[victim], task))
+        return 1;
+    }
+    return 0;
+  }
+
+  inline bool TaskPool::RunOne ()
+  {
+    Task task;
+    if (!Take(task))
+      return 0;
+    task();
+    return 1;
+  }
+
+  inline void TaskPool::Work (size_t self)
+  {
+    ThisPool()   = this;
+    ThisWorker() = self;
+    for (;;)
+    {
+      Task task;
+      if (Take(task))
+      {
+        task();
+        continue;
+      }
+      std::unique_lock<std::mutex> lock(mutex_);
+      ++sleepers_;
+      while (!stop_ && queued_ == 0)
+        ready_.wait(lock);
+      --sleepers_;
+      if (stop_ && queued_ == 0)
+        return;
+    }
+  }
+
+  inline TaskPool& TaskPool::Default ()
+  {
+    static TaskPool pool;
+    return pool;
+  }
+
+  //----------------------------------
+  //     TaskGroup
+  //----------------------------------
+
+  inline void TaskGroup::Spawn (const TaskPool::Task& task)
+  {
+    ++pending_;
+    std::atomic<size_t>* pending = &pending_;
+    pool_.Submit([task, pending]() { task(); --(*pending); });
+  }
+
+  inline void TaskGroup::Wait ()
+  {
+    while (pending_ != 0)
+    {
+      if (!pool_.RunOne())
+        std::this_thread::yield();
+    }
+  }
+
+} // namespace fsu
+
+#endif
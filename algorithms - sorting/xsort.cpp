@@ -0,0 +1,84 @@
+/*
+    xsort.cpp
+    10/19/26
+
+    sorts a binary file of numbers that may be larger than memory
+
+      xsort.x infile outfile [type [memory_MB [tempdir [fan_in]]]]
+
+    The files are raw arrays of numbers in native byte order. type is one of
+
+      u32 u64 i32 i64 f32 f64    (default u32)
+
+    memory_MB bounds the sort's buffers (default 1024); the temporary runs
+    go in tempdir (default .), which needs room for a copy of the input.
+    fan_in limits the runs merged at once (default 0: as many as memory
+    allows). See xsort.h.
+*/
+
+#include <iostream>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+
+#include <xsort.h>
+
+template < typename T >
+int Sort (const char* infile, const char* outfile, const fsu::ExternalSortOptions& options)
+{
+  fsu::ExternalSortStats stats = fsu::external_sort<T>(infile, outfile, options);
+  if (!stats.Ok())
+  {
+    std::cout << " ** " << stats.error << '\n';
+    return 1;
+  }
+  std::cout << "Results stored in file " << outfile << '\n'
+            << "  elements:      " << stats.elements << '\n'
+            << "  runs:          " << stats.runs << '\n'
+            << "  fan-in:        " << stats.fanIn << '\n'
+            << "  merge passes:  " << stats.passes << '\n'
+            << "  run formation: " << stats.formSeconds << " s\n"
+            << "  merging:       " << stats.mergeSeconds << " s\n";
+  return 0;
+}
+
+int main( int argc , char * argv[] )
+{
+  if (argc < 3 || argc > 7)
+  {
+    std::cout << " ** required arguments:\n"
+              << "     1: input file (binary)\n"
+              << "     2: output file\n"
+              << " ** optional arguments:\n"
+              << "     3: element type: u32 u64 i32 i64 f32 f64 (default u32)\n"
+              << "     4: memory in MB (default 1024)\n"
+              << "     5: directory for temporary runs (default .)\n"
+              << "     6: most runs merged at once (default 0: as memory allows)\n"
+              << " ** try again\n";
+    return 0;
+  }
+
+  const char* type = (argc > 3) ? argv[3] : "u32";
+  fsu::ExternalSortOptions options;
+  if (argc > 4) options.memory  = (size_t)atoll(argv[4]) << 20;
+  if (argc > 5) options.tempDir = argv[5];
+  if (argc > 6) options.fanIn   = (size_t)atoll(argv[6]);
+  if (options.memory == 0)
+  {
+    std::cout << " ** memory must be at least 1 MB\n"
+              << " ** try again\n";
+    return 0;
+  }
+  if (options.ioBuffer > options.memory / 8) // room for a few runs at least
+    options.ioBuffer = options.memory / 8;
+
+  if (0 == strcmp(type, "u32")) return Sort<uint32_t>(argv[1], argv[2], options);
+  if (0 == strcmp(type, "u64")) return Sort<uint64_t>(argv[1], argv[2], options);
+  if (0 == strcmp(type, "i32")) return Sort<int32_t> (argv[1], argv[2], options);
+  if (0 == strcmp(type, "i64")) return Sort<int64_t> (argv[1], argv[2], options);
+  if (0 == strcmp(type, "f32")) return Sort<float>   (argv[1], argv[2], options);
+  if (0 == strcmp(type, "f64")) return Sort<double>  (argv[1], argv[2], options);
+  std::cout << " ** unknown element type " << type << '\n'
+            << " ** try again\n";
+  return 0;
+}
@@ -0,0 +1,709 @@
+/*
+    xsort.h
+    10/19/26
+
+    external merge sort: binary files larger than memory
+
+      ExternalSortStats s = fsu::external_sort<T> (infile, outfile [[, cmp], options]);
+      if (!s.Ok()) std::cerr << s.error << '\n';
+
+    The files are raw arrays of T, native byte order, no header. T must be
+    trivially copyable: a number, or a fixed-size record with its key inside.
+    The sort runs in three stages:
+
+      1. run formation: the input is read a chunk at a time, each chunk is
+         sorted in memory on the thread pool and written to a temporary
+         run file. While one chunk is sorted, the I/O thread writes the
+         previous one and reads the next.
+      2. merge passes: while there are more runs than the fan-in, groups
+         of consecutive runs are merged into longer runs (the last of
+         these passes merges just enough of them to leave fan-in runs).
+      3. the final merge of the remaining runs into outfile.
+
+    Merges go through a loser tree (one comparison per tree level for each
+    element output), with two large sequential buffers per input run and
+    two for the output: the I/O thread fills and drains one of each pair
+    while the merge works in the other.
+
+    The in-memory sort is radix_sort (rsort.h) for integer, float and double
+    keys in default order, and g_parallel_merge_sort (gsort_par.h) for
+    everything else. Both are stable, runs are merged in input order and
+    ties go to the earlier run, so the external sort is stable.
+
+    options.memory bounds the buffers. Run formation uses three chunks of
+    memory / 3 bytes (two for reading and writing, one for the sort's
+    scratch space); a merge uses 2 * (fan-in + 1) buffers of
+    options.ioBuffer bytes. Temporary runs go in options.tempDir, which
+    needs room for one copy of the input, and are removed as they are
+    merged.
+
+    Errors (a file that cannot be opened, a short write) stop the sort,
+    remove its temporary files and are reported in ExternalSortStats::error.
+    The final merge writes beside outfile and renames its file to outfile
+    at the end, so outfile is either the whole result or not touched.
+*/
+
+#ifndef _XSORT_H
+#define _XSORT_H
+
+#include <cstdlib>   // size_t
+#include <cstdint>
+#include <cstdio>    // FILE
+#include <string>
+#include <vector>
+#include <iostream>
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <type_traits>
+#include <unistd.h>  // getpid
+#include <compare.h> // LessThan
+#include <gsort_par.h>
+#include <gsort_auto.h> // adaptive::Keyed
+#include <rsort.h>
+#include <tpool.h>
+
+namespace fsu
+{
+
+  struct ExternalSortOptions
+  {
+    size_t      memory;   // bytes of buffers, in either stage
+    size_t      ioBuffer; // bytes per read or write buffer in a merge
+    size_t      fanIn;    // most runs merged at once; 0: as many as memory allows
+    std::string tempDir;  // directory for the runs
+    TaskPool*   pool;     // for run formation; 0: TaskPool::Default()
+
+    ExternalSortOptions () : memory((size_t)1 << 30), ioBuffer((size_t)4 << 20), fanIn(0),
+                             tempDir("."), pool(0) {}
+  };
+
+  struct ExternalSortStats
+  {
+    uint64_t    elements;     // in the input
+    size_t      runs;         // formed in stage 1
+    size_t      fanIn;        // runs per merge
+    size_t      passes;       // merge passes, counting the final merge
+    double      formSeconds;  // stage 1
+    double      mergeSeconds; // stages 2 and 3
+    std::string error;        // empty on success
+
+    ExternalSortStats () : elements(0), runs(0), fanIn(0), passes(0),
+                           formSeconds(0), mergeSeconds(0) {}
+
+    bool Ok () const { return error.empty(); }
+  };
+
+  inline std::ostream& operator << (std::ostream& os, const ExternalSortStats& s)
+  {
+    if (!s.Ok())
+      return os << "external_sort failed: " << s.error;
+    return os << "external_sort (elements " << s.elements << ", runs " << s.runs
+              << ", fan-in " << s.fanIn << ", merge passes " << s.passes
+              << ", run formation " << s.formSeconds << " s, merging " << s.mergeSeconds << " s)";
+  }
+
+  namespace xsort
+  {
+
+    const size_t max_fan_in = 512; // keeps open files well under the usual limit of 1024
+
+    // one background thread that does posted jobs in order; a job posted
+    // after another starts after it has finished, so a buffer can be
+    // handed to a read posted after the write that empties it
+    class IoThread
+    {
+    public:
+      IoThread () : next_(0), posted_(0), done_(0), stop_(0), thread_(&IoThread::Work, this) {}
+
+      ~IoThread ()
+      {
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          stop_ = 1;
+        }
+        ready_.notify_all();
+        thread_.join();
+      }
+
+      // returns a ticket for Wait
+      size_t Post (const std::function<void()>& job)
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.push_back(job);
+        ready_.notify_all();
+        return ++posted_;
+      }
+
+      // returns when the job with this ticket, and every job before it, is done
+      void Wait (size_t ticket)
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (done_ < ticket)
+          finished_.wait(lock);
+      }
+
+    private:
+      void Work ()
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (1)
+        {
+          while (next_ == jobs_.size() && !stop_)
+            ready_.wait(lock);
+          if (next_ == jobs_.size())
+            return;
+          std::function<void()> job;
+          job.swap(jobs_[next_]);
+          ++next_;
+          if (next_ == jobs_.size()) // all taken: reuse the space
+          {
+            jobs_.clear();
+            next_ = 0;
+          }
+          lock.unlock();
+          job();
+          lock.lock();
+          ++done_;
+          finished_.notify_all();
+        }
+      }
+
+      IoThread (const IoThread&);             // disallowed
+      IoThread& operator = (const IoThread&); // disallowed
+
+      std::vector<std::function<void()>> jobs_;
+      size_t                  next_;     // first job not yet taken
+      size_t                  posted_;
+      size_t                  done_;
+      bool                    stop_;
+      std::mutex              mutex_;
+      std::condition_variable ready_;    // a job was posted, or stop_ set
+      std::condition_variable finished_; // a job was done
+      std::thread             thread_;   // last: starts after the rest is set up
+    };
+
+    // reads a run front to back through two buffers: the I/O thread fills
+    // one while the merge reads the other
+    template < typename T >
+    class RunReader
+    {
+    public:
+      RunReader () : file_(0), io_(0), cap_(0), cur_(0), pos_(0), end_(0), failed_(0)
+      {
+        buf_[0] = buf_[1] = 0;
+        len_[0] = len_[1] = 0;
+        ticket_[0] = ticket_[1] = 0;
+      }
+
+      ~RunReader ()
+      {
+        if (io_) io_->Wait(Last()); // no read may still be filling a buffer
+        if (file_) std::fclose(file_);
+        delete [] buf_[0];
+        delete [] buf_[1];
+      }
+
+      bool Open (const std::string& name, size_t cap, IoThread& io)
+      {
+        file_ = std::fopen(name.c_str(), "rb");
+        if (file_ == 0)
+          return 0;
+        std::setvbuf(file_, 0, _IONBF, 0);
+        io_     = &io;
+        cap_    = cap;
+        buf_[0] = new T [cap];
+        buf_[1] = new T [cap];
+        Fill(0);
+        Fill(1);
+        return 1;
+      }
+
+      // waits for the first buffer; false if the run is empty
+      bool Start ()
+      {
+        io_->Wait(ticket_[0]);
+        pos_ = buf_[0];
+        end_ = buf_[0] + len_[0];
+        return pos_ != end_;
+      }
+
+      const T* Head () const { return pos_; }
+
+      // false at the end of the run
+      bool Advance ()
+      {
+        if (++pos_ != end_)
+          return 1;
+        return Swap();
+      }
+
+      bool Failed () const { return failed_; }
+
+    private:
+      size_t Last () const { return (ticket_[0] > ticket_[1]) ? ticket_[0] : ticket_[1]; }
+
+      void Fill (size_t b)
+      {
+        ticket_[b] = io_->Post([this, b]()
+        {
+          len_[b] = std::fread(buf_[b], sizeof(T), cap_, file_);
+          if (std::ferror(file_)) failed_ = 1;
+        });
+      }
+
+      bool Swap ()
+      {
+        if (len_[cur_] < cap_) // that was the last of the file
+          return 0;
+        Fill(cur_);            // posted after the pending fill of the other buffer
+        cur_ = 1 - cur_;
+        io_->Wait(ticket_[cur_]);
+        pos_ = buf_[cur_];
+        end_ = buf_[cur_] + len_[cur_];
+        return pos_ != end_;
+      }
+
+      RunReader (const RunReader&);             // disallowed
+      RunReader& operator = (const RunReader&); // disallowed
+
+      FILE*     file_;
+      IoThread* io_;
+      size_t    cap_;      // elements per buffer
+      T*        buf_ [2];
+      size_t    len_ [2];  // elements read into each buffer
+      size_t    cur_;      // buffer being read by the merge
+      const T*  pos_;
+      const T*  end_;
+      size_t    ticket_ [2]; // of the last fill of each buffer
+      std::atomic<bool> failed_;
+    };
+
+    // writes a run (or the output) through two buffers: the I/O thread
+    // drains one while the merge fills the other
+    template < typename T >
+    class RunWriter
+    {
+    public:
+      RunWriter () : file_(0), io_(0), cap_(0), cur_(0), pos_(0), end_(0), failed_(0)
+      {
+        buf_[0] = buf_[1] = 0;
+        ticket_[0] = ticket_[1] = 0;
+      }
+
+      ~RunWriter ()
+      {
+        Close();
+        delete [] buf_[0];
+        delete [] buf_[1];
+      }
+
+      bool Open (const std::string& name, size_t cap, IoThread& io)
+      {
+        file_ = std::fopen(name.c_str(), "wb");
+        if (file_ == 0)
+          return 0;
+        std::setvbuf(file_, 0, _IONBF, 0);
+        io_     = &io;
+        cap_    = cap;
+        buf_[0] = new T [cap];
+        buf_[1] = new T [cap];
+        pos_    = buf_[0];
+        end_    = buf_[0] + cap;
+        return 1;
+      }
+
+      void Put (const T& x)
+      {
+        *pos_ = x;
+        if (++pos_ == end_)
+          Flush();
+      }
+
+      // writes what is left and closes the file; false if any write failed
+      bool Close ()
+      {
+        if (file_ == 0)
+          return !failed_;
+        Flush();
+        io_->Wait(Last());
+        if (std::fclose(file_) != 0) failed_ = 1;
+        file_ = 0;
+        return !failed_;
+      }
+
+    private:
+      size_t Last () const { return (ticket_[0] > ticket_[1]) ? ticket_[0] : ticket_[1]; }
+
+      void Flush ()
+      {
+        size_t b = cur_, n = pos_ - buf_[b];
+        if (n > 0)
+          ticket_[b] = io_->Post([this, b, n]()
+          {
+            if (std::fwrite(buf_[b], sizeof(T), n, file_) != n) failed_ = 1;
+          });
+        cur_ = 1 - cur_;
+        io_->Wait(ticket_[cur_]); // the other buffer is free once its write is done
+        pos_ = buf_[cur_];
+        end_ = buf_[cur_] + cap_;
+      }
+
+      RunWriter (const RunWriter&);             // disallowed
+      RunWriter& operator = (const RunWriter&); // disallowed
+
+      FILE*     file_;
+      IoThread* io_;
+      size_t    cap_;
+      T*        buf_ [2];
+      size_t    cur_;      // buffer being filled by the merge
+      T*        pos_;
+      T*        end_;
+      size_t    ticket_ [2]; // of the last write of each buffer
+      std::atomic<bool> failed_;
+    };
+
+    // a tournament tree over k sources: each internal node holds the loser
+    // of the match played there, node 0 the overall winner. After the
+    // winner's head changes, one replay up its path of about log k nodes
+    // restores the tree. Ties go to the lower source, which keeps merges
+    // of consecutive runs stable.
+    template < typename T , class P >
+    class LoserTree
+    {
+    public:
+      LoserTree (size_t k, P& cmp) : k_(k), tree_(k), head_(k, (const T*)0), cmp_(cmp) {}
+
+      // head of source i, 0 when it is empty; Build after setting all
+      void Set (size_t i, const T* head) { head_[i] = head; }
+
+      void Build ()
+      {
+        std::vector<size_t> winner(2 * k_);
+        for (size_t i = 0; i < k_; ++i)
+          winner[k_ + i] = i;
+        for (size_t n = k_ - 1; n > 0; --n)
+        {
+          size_t a = winner[2 * n], b = winner[2 * n + 1];
+          if (Beats(a, b)) { tree_[n] = b; winner[n] = a; }
+          else             { tree_[n] = a; winner[n] = b; }
+        }
+        tree_[0] = (k_ > 1) ? winner[1] : 0;
+      }
+
+      size_t   Winner () const { return tree_[0]; }
+      const T* Top    () const { return head_[tree_[0]]; } // 0 when every source is empty
+
+      // the winner's head has changed (0: the source is empty)
+      void Replay (const T* head)
+      {
+        size_t i = tree_[0];
+        head_[i] = head;
+        for (size_t n = (k_ + i) >> 1; n > 0; n >>= 1)
+          if (Beats(tree_[n], i))
+          {
+            size_t x = tree_[n]; tree_[n] = i; i = x;
+          }
+        tree_[0] = i;
+      }
+
+    private:
+      // whether source a comes out before source b
+      bool Beats (size_t a, size_t b) const
+      {
+        if (head_[b] == 0) return head_[a] != 0 || a < b;
+        if (head_[a] == 0) return 0;
+        return (a < b) ? !cmp_(*head_[b], *head_[a]) : cmp_(*head_[a], *head_[b]);
+      }
+
+      size_t                k_;
+      std::vector<size_t>   tree_;
+      std::vector<const T*> head_;
+      P&                    cmp_;
+    };
+
+    inline double Seconds (std::chrono::steady_clock::time_point since)
+    {
+      return std::chrono::duration<double>(std::chrono::steady_clock::now() - since).count();
+    }
+
+    // the temporary files of one sort, removed when it is done
+    class RunFiles
+    {
+    public:
+      explicit RunFiles (const std::string& dir) : dir_(dir), made_(0) {}
+      ~RunFiles () { for (size_t i = 0; i < live_.size(); ++i) std::remove(live_[i].c_str()); }
+
+      std::string Make ()
+      {
+        live_.push_back(dir_ + "/xsort." + std::to_string((long long)getpid())
+                        + "." + std::to_string((unsigned long long)made_++) + ".run");
+        return live_.back();
+      }
+
+      // a name of the caller's to remove with the rest, unless released
+      std::string Track (const std::string& name)
+      {
+        live_.push_back(name);
+        return name;
+      }
+
+      void Remove (const std::string& name)
+      {
+        std::remove(name.c_str());
+        Release(name);
+      }
+
+      // stops tracking name (it has been merged, or become the output)
+      void Release (const std::string& name)
+      {
+        for (size_t i = 0; i < live_.size(); ++i)
+          if (live_[i] == name)
+          {
+            live_.erase(live_.begin() + i);
+            return;
+          }
+      }
+
+    private:
+      std::string              dir_;
+      size_t                   made_;
+      std::vector<std::string> live_;
+    };
+
+    // the in-memory sort of a chunk: keys in default order
+    template < typename T , class P >
+    void SortChunk (T* a, size_t n, T*, P&, TaskPool& pool, std::true_type)
+    {
+      radix_sort(a, n, pool);
+    }
+
+    // any other order
+    template < typename T , class P >
+    void SortChunk (T* a, size_t n, T* scratch, P& cmp, TaskPool& pool, std::false_type)
+    {
+      MergeBuffer<T> buffer(scratch, n);
+      SortPolicy<> policy(TunedPolicy<T>::Merge(n));
+      g_parallel_merge_sort(a, a + n, buffer, cmp, pool, policy);
+    }
+
+    // stage 1: returns the runs in input order
+    template < typename T , class P >
+    std::vector<std::string> FormRuns (const char* infile, P& cmp, const ExternalSortOptions& opt,
+                                       IoThread& io, RunFiles& files, ExternalSortStats& stats)
+    {
+      typedef typename adaptive::Keyed<T*,P>::Type Keyed;
+      std::vector<std::string> runs;
+      FILE* in = std::fopen(infile, "rb");
+      if (in == 0)
+      {
+        stats.error = std::string("cannot open ") + infile;
+        return runs;
+      }
+      std::setvbuf(in, 0, _IONBF, 0);
+      TaskPool& pool  = opt.pool ? *opt.pool : TaskPool::Default();
+      size_t    chunk = opt.memory / (3 * sizeof(T));
+      if (chunk == 0) chunk = 1;
+      T*     buf [2]   = { new T [chunk], new T [chunk] };
+      T*     scratch   = Keyed::value ? 0 : new T [chunk]; // radix_sort has its own
+      size_t len [2]   = { 0, 0 };
+      std::atomic<bool> failed(0);
+      // jobs run in order on one thread, so a read into a buffer posted
+      // after the write of that buffer finds it free
+      size_t b = 0;
+      size_t read = io.Post([&, b]() { len[b] = std::fread(buf[b], sizeof(T), chunk, in); });
+      size_t last = read; // the last job posted
+      while (1)
+      {
+        io.Wait(read);
+        if (len[b] == 0 || failed)
+          break;
+        bool more = len[b] == chunk;
+        if (more)
+          last = read = io.Post([&, b]() { len[1 - b] = std::fread(buf[1 - b], sizeof(T), chunk, in); });
+        SortChunk(buf[b], len[b], scratch, cmp, pool, Keyed());
+        stats.elements += len[b];
+        runs.push_back(files.Make());
+        std::string name = runs.back();
+        size_t n = len[b];
+        last = io.Post([&, b, n, name]()
+        {
+          FILE* out = std::fopen(name.c_str(), "wb");
+          if (out == 0 || std::fwrite(buf[b], sizeof(T), n, out) != n) failed = 1;
+          if (out != 0 && std::fclose(out) != 0) failed = 1;
+        });
+        if (!more)
+          break;
+        b = 1 - b;
+      }
+      io.Wait(last);
+      if (std::ferror(in))
+        stats.error = std::string("cannot read ") + infile;
+      else if (failed)
+        stats.error = "cannot write a run in " + opt.tempDir;
+      std::fclose(in);
+      delete [] buf[0];
+      delete [] buf[1];
+      delete [] scratch;
+      return runs;
+    }
+
+    // merges runs[lo, hi) into outfile
+    template < typename T , class P >
+    bool Merge (const std::vector<std::string>& runs, size_t lo, size_t hi, const std::string& outfile,
+                size_t cap, P& cmp, IoThread& io, ExternalSortStats& stats)
+    {
+      size_t k = hi - lo;
+      RunReader<T>* in = new RunReader<T> [k];
+      RunWriter<T>  out;
+      bool ok = 1;
+      for (size_t i = 0; ok && i < k; ++i)
+        if (!in[i].Open(runs[lo + i], cap, io))
+        {
+          stats.error = "cannot open " + runs[lo + i];
+          ok = 0;
+        }
+      if (ok && !out.Open(outfile, cap, io))
+      {
+        stats.error = "cannot open " + outfile;
+        ok = 0;
+      }
+      if (ok && k > 0)
+      {
+        LoserTree < T , P > tree(k, cmp);
+        for (size_t i = 0; i < k; ++i)
+          tree.Set(i, in[i].Start() ? in[i].Head() : 0);
+        tree.Build();
+        for (const T* top = tree.Top(); top != 0; top = tree.Top())
+        {
+          out.Put(*top);
+          RunReader<T>& r = in[tree.Winner()];
+          tree.Replay(r.Advance() ? r.Head() : 0);
+        }
+      }
+      // the output's last write was posted after every read: once it is
+      // done, so are they
+      if (ok && !out.Close())
+      {
+        stats.error = "cannot write " + outfile;
+        ok = 0;
+      }
+      for (size_t i = 0; ok && i < k; ++i)
+        if (in[i].Failed())
+        {
+          stats.error = "cannot read " + runs[lo + i];
+          ok = 0;
+        }
+      delete [] in;
+      return ok;
+    }
+
+  } // namespace xsort
+
+  template < typename T , class Comparator >
+  ExternalSortStats external_sort (const char* infile, const char* outfile, Comparator& cmp,
+                                   const ExternalSortOptions& options)
+  {
+    static_assert(std::is_trivially_copyable<T>::value, "external_sort: elements are copied as bytes");
+    ExternalSortStats stats;
+    xsort::IoThread   io;
+    xsort::RunFiles   files(options.tempDir);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::vector<std::string> runs = xsort::FormRuns<T>(infile, cmp, options, io, files, stats);
+    stats.formSeconds = xsort::Seconds(start);
+    stats.runs        = runs.size();
+    if (!stats.Ok())
+      return stats;
+
+    start = std::chrono::steady_clock::now();
+    size_t cap = options.ioBuffer / sizeof(T);
+    if (cap == 0) cap = 1;
+    size_t fan = options.fanIn;
+    if (fan == 0)
+    {
+      size_t buffers = options.memory / (cap * sizeof(T)); // two per run, two for the output
+      fan = (buffers > 4) ? buffers / 2 - 1 : 2;
+    }
+    if (fan > xsort::max_fan_in) fan = xsort::max_fan_in;
+    if (fan < 2)                 fan = 2;
+    stats.fanIn = fan;
+
+    if (runs.size() == 1 && std::rename(runs[0].c_str(), outfile) == 0) // the one run is the output
+    {
+      files.Release(runs[0]);
+      stats.mergeSeconds = xsort::Seconds(start);
+      return stats;
+    }
+    while (runs.size() > fan)
+    {
+      // when one pass can bring the runs down to fan, it merges only as
+      // many as that takes, smallest group first, and carries the rest
+      // over unread; otherwise it merges all of them, fan at a time
+      size_t excess = runs.size() - fan;
+      size_t merges = (excess + fan - 2) / (fan - 1);
+      size_t take   = excess - (merges - 1) * (fan - 1) + 1;
+      if (merges * fan > runs.size())
+      {
+        merges = (runs.size() + fan - 1) / fan;
+        take   = fan;
+      }
+      std::vector<std::string> next;
+      for (size_t lo = 0; lo < runs.size(); )
+      {
+        size_t hi = (lo + take < runs.size()) ? lo + take : runs.size();
+        if (merges == 0 || hi - lo == 1) // carried to the next pass as it is
+        {
+          next.push_back(runs[lo++]);
+          continue;
+        }
+        next.push_back(files.Make());
+        if (!xsort::Merge<T>(runs, lo, hi, next.back(), cap, cmp, io, stats))
+          return stats;
+        for (size_t i = lo; i < hi; ++i)
+          files.Remove(runs[i]);
+        lo   = hi;
+        take = fan;
+        --merges;
+      }
+      runs.swap(next);
+      ++stats.passes;
+    }
+    // the final merge; no runs (an empty input) makes an empty outfile.
+    // It goes to a file beside outfile, renamed to outfile only when it is
+    // complete, so a failed sort never leaves a partial outfile behind.
+    std::string part = files.Track(std::string(outfile) + ".xsort."
+                                   + std::to_string((long long)getpid()) + ".part");
+    if (!xsort::Merge<T>(runs, 0, runs.size(), part, cap, cmp, io, stats))
+      return stats;
+    if (std::rename(part.c_str(), outfile) != 0)
+    {
+      stats.error = std::string("cannot rename ") + part + " to " + outfile;
+      return stats;
+    }
+    files.Release(part);
+    ++stats.passes;
+    stats.mergeSeconds = xsort::Seconds(start);
+    return stats;
+  }
+
+  template < typename T >
+  ExternalSortStats external_sort (const char* infile, const char* outfile, const ExternalSortOptions& options)
+  {
+    fsu::LessThan<T> lt;
+    return external_sort<T>(infile, outfile, lt, options);
+  }
+
+  template < typename T >
+  ExternalSortStats external_sort (const char* infile, const char* outfile)
+  {
+    ExternalSortOptions options;
+    return external_sort<T>(infile, outfile, options);
+  }
+
+} // namespace fsu
+
+#endif